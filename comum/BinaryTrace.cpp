@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+// Binary traces start with a 24 byte little-endian header:
+//   0  "SO1T"
+//   4  version (1)
+//   5  kind: 'P' for processes, 'M' for memory references
+//   6  reserved
+//   8  number of frames (memory traces only)
+//   12 reserved
+//   16 number of records
+// followed by the records, as LEB128 varints:
+//   processes: zigzag(arrival time - previous arrival time), duration, zigzag(priority), zigzag(CPU it's pinned to, -1 for any)
+//   memory:    zigzag(page number - previous page number) << 2 | whether its process changed << 1 | whether it's a write,
+//              then the process' id if it changed (starting from 0). Deltas wrap around 64 bits and, with the flags, must fit in 64 bits, so page numbers or addresses up to 2^61 are always fine
+const char BINARY_TRACE_MAGIC[4] = { 'S', 'O', '1', 'T' };
+const std::uint8_t BINARY_TRACE_VERSION = 1;
+const std::size_t BINARY_TRACE_HEADER_SIZE = 24;
+const char PROCESS_TRACE = 'P';
+const char MEMORY_TRACE = 'M';
+
+std::uint64_t zigzag(const std::int64_t& value) {
+    return ((std::uint64_t)value << 1) ^ (std::uint64_t)(value >> 63);
+}
+
+std::int64_t unzigzag(const std::uint64_t& value) {
+    return (std::int64_t)(value >> 1) ^ -(std::int64_t)(value & 1);
+}
+
+std::uint64_t readLittleEndian(const char* bytes, const int& size) {
+    std::uint64_t value = 0;
+
+    for (int i = size - 1; i >= 0; i--) {
+        value = value << 8 | (std::uint8_t)bytes[i];
+    }
+
+    return value;
+}
+
+class BinaryTraceWriter {
+private:
+    std::ofstream output;
+    char kind;
+    std::uint32_t framesN;
+    std::uint64_t recordsN = 0;
+    // Deltas are taken from the previous record's first value, wrapping around so any 64-bit address fits
+    std::uint64_t previous = 0;
+    int previousPid = 0;
+
+    void writeLittleEndian(const std::uint64_t& value, const int& size) {
+        for (int i = 0; i < size; i++) {
+            this->output.put((char)(value >> (8 * i)));
+        }
+    }
+
+    void writeHeader() {
+        this->output.seekp(0);
+        this->output.write(BINARY_TRACE_MAGIC, 4);
+        this->writeLittleEndian(BINARY_TRACE_VERSION, 1);
+        this->writeLittleEndian(this->kind, 1);
+        this->writeLittleEndian(0, 2);
+        this->writeLittleEndian(this->framesN, 4);
+        this->writeLittleEndian(0, 4);
+        this->writeLittleEndian(this->recordsN, 8);
+    }
+
+    void writeVarint(std::uint64_t value) {
+        while (value >= 0x80) {
+            this->output.put((char)(value | 0x80));
+            value >>= 7;
+        }
+
+        this->output.put((char)value);
+    }
+
+public:
+    BinaryTraceWriter(const std::string& path, const char& kind, const int& framesN = 0) : output(path, std::ios::binary), kind(kind), framesN(framesN) {
+        if (!this->output) {
+            throw std::invalid_argument("Couldn't open " + path + " for writing.");
+        }
+
+        // Written again once the number of records is known
+        this->writeHeader();
+    }
+
+    ~BinaryTraceWriter() {
+        this->writeHeader();
+    }
+
+    void writeProcess(const int& arrivalTime, const int& duration, const int& priority, const int& cpu = -1) {
+        this->writeVarint(zigzag((std::int64_t)((std::uint64_t)arrivalTime - this->previous)));
+        this->writeVarint(duration);
+        this->writeVarint(zigzag(priority));
+        this->writeVarint(zigzag(cpu));
+
+        this->previous = arrivalTime;
+        this->recordsN += 1;
+    }
+
+    void writeReference(const std::uint64_t& pageNumber, const bool& write = false, const int& pid = 0) {
+        bool pidChanged = pid != this->previousPid;
+        std::uint64_t delta = zigzag((std::int64_t)(pageNumber - this->previous));
+
+        if (delta >> 62 != 0) {
+            throw std::invalid_argument("Page numbers this far apart don't fit in a binary trace.");
+        }
+
+        this->writeVarint(delta << 2 | pidChanged << 1 | write);
+        if (pidChanged) {
+            this->writeVarint(pid);
+            this->previousPid = pid;
+        }
+
+        this->previous = pageNumber;
+        this->recordsN += 1;
+    }
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+// Streaming histogram in the style of HdrHistogram: each power of two is split into the same number of buckets, so any value is known to within 1% of itself in constant memory, however many are added. Values can't be negative
+class Histogram {
+private:
+    // Powers of two are split into 2^(subBucketBits - 1) buckets, values below 2^subBucketBits being exact
+    static const int subBucketBits = 8;
+    std::vector<long> counts;
+    long _count = 0;
+    long _max = LONG_MIN;
+    long _min = LONG_MAX;
+
+    static int bucket(const unsigned long& value) {
+        int shift = std::max(0, 63 - __builtin_clzl(value | 1) - (subBucketBits - 1));
+
+        return (shift << (subBucketBits - 1)) + (int)(value >> shift);
+    }
+
+    // Smallest value in the bucket
+    static unsigned long lowest(const int& bucket) {
+        int shift = std::max(0, (bucket >> (subBucketBits - 1)) - 1);
+
+        return (unsigned long)(bucket - (shift << (subBucketBits - 1))) << shift;
+    }
+
+    // Largest value in the bucket
+    static unsigned long highest(const int& bucket) {
+        int shift = std::max(0, (bucket >> (subBucketBits - 1)) - 1);
+
+        return lowest(bucket) + ((1UL << shift) - 1);
+    }
+
+public:
+    void add(const long& value) {
+        if (value < 0) {
+            throw std::invalid_argument("Histograms can't take negative values.");
+        }
+
+        int index = bucket(value);
+        if (index >= (int)this->counts.size()) {
+            this->counts.resize(index + 1, 0);
+        }
+        this->counts[index] += 1;
+
+        this->_count += 1;
+        this->_max = std::max(this->_max, value);
+        this->_min = std::min(this->_min, value);
+    }
+
+    long count() const {
+        return this->_count;
+    }
+
+    long max() const {
+        return this->_count > 0 ? this->_max : 0;
+    }
+
+    long min() const {
+        return this->_count > 0 ? this->_min : 0;
+    }
+
+    // Largest value among the lowest `percent`% of them, or at most 1% above it
+    long percentile(const double& percent) const {
+        if (this->_count == 0) {
+            return 0;
+        }
+
+        long rank = std::max(1L, (long)std::ceil(percent / 100 * this->_count));
+        long seen = 0;
+
+        for (int index = 0; index < (int)this->counts.size(); index++) {
+            seen += this->counts[index];
+            if (seen >= rank) {
+                return std::min(this->_max, (long)highest(index));
+            }
+        }
+
+        return this->_max;
+    }
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Seeded random numbers that are the same on every platform. mt19937_64's output is fixed by the standard, but <random>'s distributions aren't, so they're sampled here by inversion instead
+class Random {
+private:
+    std::mt19937_64 engine;
+
+public:
+    explicit Random(const std::uint64_t& seed) : engine(seed) {}
+
+    // In [0, 1)
+    double uniform() {
+        return (this->engine() >> 11) * 0x1.0p-53;
+    }
+
+    // In [0, n)
+    long uniformInt(const long& n) {
+        return (long)(this->uniform() * n);
+    }
+
+    double exponential(const double& mean) {
+        return -mean * std::log1p(-this->uniform());
+    }
+
+    // Heavy-tailed, at least `minimum`, with infinite variance when alpha <= 2
+    double pareto(const double& alpha, const double& minimum) {
+        return minimum / std::pow(1 - this->uniform(), 1 / alpha);
+    }
+};
+
+// Distribution given as "exp:MEAN", "pareto:ALPHA:MIN" or "uniform:MIN:MAX"
+class Distribution {
+private:
+    std::string kind;
+    double a = 0;
+    double b = 0;
+
+public:
+    explicit Distribution(const std::string& spec) {
+        std::istringstream stream(spec);
+        std::string field;
+        std::vector<double> params;
+
+        std::getline(stream, this->kind, ':');
+        while (std::getline(stream, field, ':')) {
+            params.push_back(std::stod(field));
+        }
+
+        std::size_t expected = this->kind == "exp" ? 1 : 2;
+        if ((this->kind != "exp" && this->kind != "pareto" && this->kind != "uniform") || params.size() != expected) {
+            throw std::invalid_argument("Only exp:MEAN, pareto:ALPHA:MIN and uniform:MIN:MAX distributions are supported.");
+        }
+
+        this->a = params[0];
+        this->b = expected > 1 ? params[1] : 0;
+    }
+
+    double sample(Random& random) const {
+        if (this->kind == "exp") {
+            return random.exponential(this->a);
+        } else if (this->kind == "pareto") {
+            return random.pareto(this->a, this->b);
+        }
+
+        return this->a + random.uniform() * (this->b - this->a);
+    }
+};
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "./BinaryTrace.cpp"
+
+// Reads whitespace separated integers, a line at a time, straight off a memory-mapped file. Pages that were already read are given back to the OS every so often, so memory use doesn't grow with the file. Binary traces are decoded into the same lines their text version would have
+class TraceReader {
+private:
+    // Handed back once this many bytes past the last release were read
+    static constexpr std::size_t releaseSize = 16 << 20;
+
+    const char* data = nullptr;
+    std::size_t size = 0;
+    std::size_t position = 0;
+    std::size_t released = 0;
+    // Binary traces' kind, or 0 for text
+    char kind = 0;
+    int framesN = 0;
+    // Whether a memory trace's number of frames is yet to be read
+    bool framesPending = false;
+    // Wraps around like the writer's, so 64-bit addresses survive the deltas
+    std::uint64_t previous = 0;
+    int previousPid = 0;
+    std::uint64_t remaining = 0;
+
+    std::uint64_t readVarint() {
+        std::uint64_t value = 0;
+
+        for (int shift = 0;; shift += 7) {
+            if (this->position >= this->size) {
+                throw std::invalid_argument("Binary trace ended in the middle of a record.");
+            }
+
+            std::uint8_t byte = this->data[this->position++];
+            value |= (std::uint64_t)(byte & 0x7f) << shift;
+
+            if (byte < 0x80) {
+                return value;
+            }
+        }
+    }
+
+    // Decodes the next record, which takes the place of a line
+    template <typename Integer>
+    int readRecord(Integer* values, const int& maxValues) {
+        // Memory traces' first line is their number of frames
+        if (this->framesPending) {
+            values[0] = this->framesN;
+            this->framesPending = false;
+
+            return 1;
+        }
+
+        if (this->remaining == 0) {
+            return 0;
+        }
+
+        // Arrival time, duration, priority and CPU, or page number, whether it's a write and process
+        std::uint64_t decoded[4];
+        int decodedN = 3;
+        std::uint64_t first = this->readVarint();
+
+        if (this->kind == PROCESS_TRACE) {
+            decoded[1] = this->readVarint();
+            decoded[2] = unzigzag(this->readVarint());
+            decoded[3] = unzigzag(this->readVarint());
+            decodedN = 4;
+        } else {
+            // Memory references' first varint also holds whether it's a write and whether the process changed
+            decoded[1] = first & 1;
+            if (first & 2) {
+                this->previousPid = this->readVarint();
+            }
+            decoded[2] = this->previousPid;
+            first >>= 2;
+        }
+
+        // The first field is a delta
+        this->previous += (std::uint64_t)unzigzag(first);
+        decoded[0] = this->previous;
+
+        for (int i = 0; i < decodedN && i < maxValues; i++) {
+            values[i] = (Integer)decoded[i];
+        }
+        this->remaining -= 1;
+
+        return std::min(decodedN, maxValues);
+    }
+
+    void release() {
+        std::size_t pageSize = sysconf(_SC_PAGESIZE);
+        std::size_t end = std::min(this->position, this->size) / pageSize * pageSize;
+
+        madvise((void*)(this->data + this->released), end - this->released, MADV_DONTNEED);
+        this->released = end;
+    }
+
+public:
+    // Constructors
+    // Binary traces of any kind but the expected one (if given) are refused
+    explicit TraceReader(const std::string& path, const char& expectedKind = 0) {
+        int file = open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            return;
+        }
+
+        struct stat info;
+        if (fstat(file, &info) == 0 && info.st_size > 0) {
+            void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+            if (mapping != MAP_FAILED) {
+                this->data = (const char*)mapping;
+                this->size = info.st_size;
+
+                madvise(mapping, this->size, MADV_SEQUENTIAL);
+
+                if (this->size >= BINARY_TRACE_HEADER_SIZE && std::equal(BINARY_TRACE_MAGIC, BINARY_TRACE_MAGIC + 4, this->data)) {
+                    const char* error = nullptr;
+                    if ((std::uint8_t)this->data[4] != BINARY_TRACE_VERSION) {
+                        error = "Unsupported binary trace version.";
+                    } else if (expectedKind != 0 && this->data[5] != expectedKind) {
+                        error = "Binary trace is of the wrong kind.";
+                    }
+
+                    if (error != nullptr) {
+                        munmap(mapping, this->size);
+                        close(file);
+
+                        throw std::invalid_argument(error);
+                    }
+
+                    this->kind = this->data[5];
+                    this->framesN = readLittleEndian(this->data + 8, 4);
+                    this->framesPending = this->kind == MEMORY_TRACE;
+                    this->remaining = readLittleEndian(this->data + 16, 8);
+                    this->position = BINARY_TRACE_HEADER_SIZE;
+                }
+            }
+        }
+
+        close(file);
+    }
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    ~TraceReader() {
+        if (this->data != nullptr) {
+            munmap((void*)this->data, this->size);
+        }
+    }
+
+    // Parses up to maxValues integers from the next non-empty line, skipping whatever's left of it. Returns how many were read, 0 meaning the file ended. Memory traces are read into 64-bit integers, as their addresses may not fit in an int
+    template <typename Integer>
+    int readLine(Integer* values, const int& maxValues) {
+        if (this->kind != 0) {
+            int valuesN = this->readRecord(values, maxValues);
+
+            if (this->position - this->released >= releaseSize) {
+                this->release();
+            }
+
+            return valuesN;
+        }
+
+        int valuesN = 0;
+
+        while (valuesN == 0 && this->position < this->size) {
+            const char* end = this->data + this->size;
+            const char* cursor = this->data + this->position;
+
+            while (cursor < end && *cursor != '\n') {
+                if (*cursor == ' ' || *cursor == '\t' || *cursor == '\r') {
+                    cursor++;
+                } else if (valuesN < maxValues) {
+                    std::from_chars_result result = std::from_chars(cursor, end, values[valuesN]);
+                    if (result.ec != std::errc()) {
+                        // Quoting at most the rest of the line
+                        const char* quoted = std::find(cursor, std::min(end, cursor + 16), '\n');
+                        throw std::invalid_argument("Invalid number in trace: " + std::string(cursor, quoted));
+                    }
+
+                    cursor = result.ptr;
+                    valuesN += 1;
+                } else {
+                    cursor++;
+                }
+            }
+
+            this->position = cursor - this->data + 1;
+        }
+
+        if (this->position - this->released >= releaseSize) {
+            this->release();
+        }
+
+        return valuesN;
+    }
+};
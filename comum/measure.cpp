@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+struct BenchmarkResult {
+    std::string name;
+    long size;
+    // Only for memory benchmarks
+    long framesN;
+    double nsPerOperation;
+    long peakRssKb;
+};
+
+// Times `body` `repetitions` times, returning the fastest run's nanoseconds per operation, as counted by the body itself (the same on every run)
+double timeBest(const int& repetitions, const std::function<long()>& body) {
+    double best = std::numeric_limits<double>::max();
+    long operationsN = 1;
+
+    for (int i = 0; i < repetitions; i++) {
+        auto start = std::chrono::steady_clock::now();
+        operationsN = body();
+        auto end = std::chrono::steady_clock::now();
+
+        best = std::min(best, (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    return best / std::max(operationsN, 1L);
+}
+
+// Times `body` (which does operationsN operations) `repetitions` times, returning the fastest run's nanoseconds per operation
+double timeBest(const int& repetitions, const long& operationsN, const std::function<void()>& body) {
+    return timeBest(repetitions, [&]() {
+        body();
+
+        return operationsN;
+    });
+}
+
+// Runs a benchmark case, which returns its nanoseconds per operation, in a child process so its peak RSS is only its own. That peak covers all of `run`, so it includes whatever the case sets up before timing
+BenchmarkResult measure(const std::string& name, const long& size, const long& framesN, const std::function<double()>& run) {
+    int channel[2];
+    if (pipe(channel) != 0) {
+        throw std::runtime_error("Couldn't create a pipe for the benchmark.");
+    }
+
+    std::cout.flush();
+    pid_t child = fork();
+    if (child < 0) {
+        throw std::runtime_error("Couldn't fork the benchmark.");
+    }
+
+    if (child == 0) {
+        close(channel[0]);
+
+        // It must never return into the parent's code
+        try {
+            double nsPerOperation = run();
+            bool written = write(channel[1], &nsPerOperation, sizeof(nsPerOperation)) == sizeof(nsPerOperation);
+
+            _exit(written ? 0 : 1);
+        } catch (const std::exception& error) {
+            std::cerr << error.what() << std::endl;
+        }
+
+        _exit(1);
+    }
+
+    close(channel[1]);
+
+    double nsPerOperation = 0;
+    bool read = ::read(channel[0], &nsPerOperation, sizeof(nsPerOperation)) == sizeof(nsPerOperation);
+    close(channel[0]);
+
+    int status;
+    struct rusage usage;
+    wait4(child, &status, 0, &usage);
+
+    if (!read || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw std::runtime_error("Benchmark " + name + " failed.");
+    }
+
+    // Linux gives it in kilobytes
+    return { name, size, framesN, nsPerOperation, usage.ru_maxrss };
+}
+
+// Frames are only saved for memory benchmarks
+void saveResults(const std::string& path, const std::vector<BenchmarkResult>& results, const bool& frames = true) {
+    std::ofstream file(path);
+    if (!file) {
+        throw std::invalid_argument("Couldn't open " + path + " for writing.");
+    }
+
+    file << "caso,tamanho," << (frames ? "quadros," : "") << "ns_por_operacao,pico_rss_kb" << std::endl;
+    for (const BenchmarkResult& result : results) {
+        file << result.name << "," << result.size << ",";
+        if (frames) {
+            file << result.framesN << ",";
+        }
+        file << std::fixed << std::setprecision(3) << result.nsPerOperation << "," << result.peakRssKb << std::endl;
+    }
+}
+
+std::vector<BenchmarkResult> loadResults(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::invalid_argument("Couldn't open " + path + ".");
+    }
+
+    std::vector<BenchmarkResult> results;
+    std::string line;
+
+    // The header tells whether there are frames
+    std::getline(file, line);
+    bool frames = line.find(",quadros,") != std::string::npos;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string name, size, framesN = "0", nsPerOperation, peakRssKb;
+
+        if (std::getline(fields, name, ',') && std::getline(fields, size, ',') && (!frames || std::getline(fields, framesN, ',')) && std::getline(fields, nsPerOperation, ',') && std::getline(fields, peakRssKb, ',')) {
+            results.push_back({ name, std::stol(size), std::stol(framesN), std::stod(nsPerOperation), std::stol(peakRssKb) });
+        }
+    }
+
+    return results;
+}
+
+// Column names for printResult, given what an operation is and whether there are frames
+void printHeader(const std::string& operation, const bool& frames = true) {
+    std::cout << std::left << std::setw(16) << "caso" << std::right << std::setw(10) << "tamanho";
+    if (frames) {
+        std::cout << std::setw(9) << "quadros";
+    }
+    std::cout << std::setw(15) << "ns/" + operation << std::setw(10) << "rss (kB)" << std::endl;
+}
+
+// Prints a result, and how it compares to the same case in the baseline if there's one. Runs over `tolerance` times slower are flagged
+void printResult(const BenchmarkResult& result, const std::vector<BenchmarkResult>& baseline, const bool& frames = true, const double& tolerance = 1.1) {
+    std::cout << std::left << std::setw(16) << result.name << std::right << std::setw(10) << result.size;
+    if (frames) {
+        std::cout << std::setw(9) << result.framesN;
+    }
+    std::cout << std::fixed << std::setprecision(1) << std::setw(14) << result.nsPerOperation << std::setw(10) << result.peakRssKb;
+
+    auto found = std::find_if(baseline.begin(), baseline.end(), [&](const BenchmarkResult& other) {
+        return std::tie(other.name, other.size, other.framesN) == std::tie(result.name, result.size, result.framesN);
+    });
+
+    if (found != baseline.end() && found->nsPerOperation > 0) {
+        double ratio = result.nsPerOperation / found->nsPerOperation;
+
+        std::cout << std::setprecision(2) << std::setw(8) << ratio << "x" << (ratio > tolerance ? " REGRESSÃO" : "");
+    }
+
+    std::cout << std::defaultfloat << std::endl;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Runs job(0) through job(jobsN - 1) on a pool of up to threadsN threads, each one picking the next job as soon as it's free. Rethrows the first job's exception, if any
+void parallelFor(const int& jobsN, const std::function<void(int)>& job, int threadsN = std::thread::hardware_concurrency()) {
+    threadsN = std::max(1, std::min(threadsN, jobsN));
+
+    std::atomic<int> nextJob(0);
+    std::vector<std::exception_ptr> errors(jobsN);
+    std::vector<std::thread> workers;
+
+    for (int i = 0; i < threadsN; i++) {
+        workers.emplace_back([&]() {
+            for (int j = nextJob++; j < jobsN; j = nextJob++) {
+                try {
+                    job(j);
+                } catch (...) {
+                    errors[j] = std::current_exception();
+                }
+            }
+        });
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
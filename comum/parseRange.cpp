@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Parses "start:end" or "start:end:step" (both ends included), or a single number
+std::vector<int> parseRange(const std::string& range) {
+    std::vector<int> bounds;
+    std::size_t start = 0;
+
+    while (start <= range.length()) {
+        std::size_t end = range.find(':', start);
+        if (end == std::string::npos) {
+            end = range.length();
+        }
+
+        bounds.push_back(std::stoi(range.substr(start, end - start)));
+        start = end + 1;
+    }
+
+    if (bounds.size() > 3) {
+        throw std::invalid_argument("Ranges must be given as start:end or start:end:step.");
+    }
+
+    int first = bounds[0], last = bounds.size() > 1 ? bounds[1] : first, step = bounds.size() > 2 ? bounds[2] : 1;
+    if (step <= 0) {
+        throw std::invalid_argument("Range steps must be positive.");
+    }
+
+    if (first > last) {
+        throw std::invalid_argument("Ranges can't end before they start.");
+    }
+
+    std::vector<int> values;
+    for (long value = first; value <= last; value += step) {
+        values.push_back(value);
+    }
+
+    return values;
+}
@@ -1,15 +1,16 @@
+#pragma once
+
 #include <string>
 #include <vector>
 
-using namespace std;
-
-vector<string> split(string str, const char* separator) {
+// Splits the string at every separator, keeping empty words
+std::vector<std::string> split(std::string str, const char* separator) {
     int i = 0, startIndex = 0;
-    vector<string> words;
+    std::vector<std::string> words;
 
     while (i <= (int)str.length() + 1) {
         if (i == (int)str.length() + 1 || str[i] == *separator) {
-            string subString = "";
+            std::string subString = "";
             subString.append(str, startIndex, i - startIndex);
 
             words.push_back(subString);
@@ -0,0 +1 @@
+cd "$(dirname "$0")" && mkdir -p build && g++ -O2 src/benchmark.cpp -o build/benchmark.exe && ./build/benchmark.exe "$@"
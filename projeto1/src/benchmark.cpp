@@ -0,0 +1,102 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "./classes/Arrivals.cpp"
+#include "./classes/Scheduler.cpp"
+#include "./classes/WorkloadGenerator.cpp"
+#include "../../comum/measure.cpp"
+#include "./utils/simulate.cpp"
+#include "../../comum/split.cpp"
+
+// Times every policy's scheduler over synthetic traces of every size, per scheduling event (an arrival or a process running until it finishes, is preempted or the next one arrives), each case in its own process. Results can be saved and compared against ones saved before, e.g. from another commit
+int main(int argc, char* argv[]) {
+    std::vector<std::string> policies = { "fcfs", "sjf", "srtf", "rr", "priority", "aging" };
+    std::vector<long> sizes = { 1000, 10000, 100000, 1000000, 10000000 };
+    int repetitions = 3;
+    // Go one time unit at a time instead of jumping between events
+    bool ticks = false;
+    // Around 90% of the CPU is used with the default durations
+    WorkloadConfig workload = { 0, 0.09, "exp:10", 4, 1 };
+    std::string output, baselinePath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--policies" && i + 1 < argc) {
+            policies = split(argv[++i], ",");
+        } else if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            for (const std::string& size : split(argv[++i], ",")) {
+                sizes.push_back(std::stol(size));
+            }
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            repetitions = std::stoi(argv[++i]);
+        } else if (arg == "--ticks") {
+            ticks = true;
+        } else if (arg == "--arrival-rate" && i + 1 < argc) {
+            workload.arrivalRate = std::stod(argv[++i]);
+        } else if (arg == "--burst" && i + 1 < argc) {
+            workload.burst = argv[++i];
+        } else if (arg == "--seed" && i + 1 < argc) {
+            workload.seed = std::stoull(argv[++i]);
+        } else if (arg == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "--compare" && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else {
+            std::cout << "Opção desconhecida: " << arg << std::endl;
+
+            return 1;
+        }
+    }
+
+    std::vector<BenchmarkResult> baseline, results;
+    if (!baselinePath.empty()) {
+        baseline = loadResults(baselinePath);
+    }
+
+    printHeader("evento", false);
+    for (const std::string& policy : policies) {
+        for (const long& size : sizes) {
+            BenchmarkResult result = measure(policy, size, 0, [&]() {
+                WorkloadConfig config = workload;
+                config.processesN = size;
+
+                // The trace is generated up front, so only the scheduler is timed. Its peak RSS does include the generation, which keeps the trace's growth and the generator's state in the case's own process
+                Trace trace;
+                WorkloadGenerator generator(config);
+                int arrivalTime, duration, priority, pid = 0;
+                while (generator.next(arrivalTime, duration, priority)) {
+                    trace[arrivalTime].push_back(Process(pid++, duration, priority));
+                }
+
+                std::vector<int> params;
+                if (policy == "rr") {
+                    params = { 2 };
+                } else if (policy == "aging") {
+                    params = { 10 };
+                }
+
+                return timeBest(repetitions, [&]() {
+                    Scheduler scheduler({ policy }, params);
+                    TraceArrivals arrivals(trace);
+
+                    simulate(scheduler, arrivals, !ticks);
+
+                    return size + scheduler.statistics().runs();
+                });
+            });
+
+            printResult(result, baseline, false);
+            results.push_back(result);
+        }
+    }
+
+    if (!output.empty()) {
+        saveResults(output, results, false);
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "./Process.cpp"
+#include "../../../comum/TraceReader.cpp"
+
+// {
+//     [Arrival time]: duration[]
+// }
+typedef std::map<int, std::vector<Process>> Trace;
+
+// Walks a trace that's already in memory, one batch of processes arriving at the same time at a time
+class TraceArrivals {
+private:
+    Trace::const_iterator current;
+    Trace::const_iterator end;
+
+public:
+    explicit TraceArrivals(const Trace& trace) : current(trace.begin()), end(trace.end()) {}
+
+    // Returns the next batch (or nullptr if there are none left) and when it arrives
+    const std::vector<Process>* next(int& arrivalTime) {
+        if (this->current == this->end) {
+            return nullptr;
+        }
+
+        arrivalTime = this->current->first;
+
+        return &(this->current++)->second;
+    }
+};
+
+// Reads batches straight from a trace file as they're needed, instead of loading it whole. Processes may be out of order by up to lookahead lines, which get sorted in a window of that many processes past the current batch
+class StreamedArrivals {
+private:
+    std::vector<Process> batch;
+    TraceReader reader;
+    // Batches already read, by arrival time, and how many processes they have
+    Trace window;
+    int windowN = 0;
+    int lookahead;
+    // When the last batch handed out arrived, as nothing can arrive before it anymore
+    int lastArrival = std::numeric_limits<int>::min();
+    bool ended = false;
+    // Pids are handed out in input order
+    int processesN = 0;
+
+    // Reads the next line into the window, if there's one
+    void read() {
+        int info[4];
+        int infoN = this->reader.readLine(info, 4);
+
+        if (infoN == 0) {
+            this->ended = true;
+
+            return;
+        }
+
+        if (infoN < 2) {
+            throw std::invalid_argument("Every process needs an arrival time and a duration.");
+        }
+
+        if (info[0] <= this->lastArrival) {
+            throw std::invalid_argument("Streamed traces can't be out of order by more than " + std::to_string(this->lookahead) + " processes. Use a larger --lookahead or run without --stream.");
+        }
+
+        // Priority is only used by multilevel and priority schedulers, and the CPU by multiprocessor ones
+        this->window[info[0]].push_back(Process(this->processesN, info[1], infoN > 2 ? info[2] : 0, infoN > 3 ? info[3] : -1));
+        this->processesN += 1;
+        this->windowN += 1;
+    }
+
+public:
+    explicit StreamedArrivals(const std::string& path, const int& lookahead = 4096) : reader(path, PROCESS_TRACE), lookahead(lookahead) {}
+
+    const std::vector<Process>* next(int& arrivalTime) {
+        // The earliest batch is complete once there are lookahead processes past it
+        while (!this->ended && (this->window.empty() || this->windowN - (int)this->window.begin()->second.size() < this->lookahead)) {
+            this->read();
+        }
+
+        if (this->window.empty()) {
+            return nullptr;
+        }
+
+        auto earliest = this->window.begin();
+        arrivalTime = this->lastArrival = earliest->first;
+        this->batch.swap(earliest->second);
+        this->windowN -= this->batch.size();
+        this->window.erase(earliest);
+
+        return &this->batch;
+    }
+};
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Schedulers only record events when compiled with -DSCHEDULER_TRACING, otherwise tracing costs nothing at all
+#ifdef SCHEDULER_TRACING
+#define TRACE_EVENT(events, ...) \
+    do { \
+        if ((events) != nullptr) { \
+            (events)->push({ __VA_ARGS__ }); \
+        } \
+    } while (0)
+#else
+#define TRACE_EVENT(events, ...) \
+    do { \
+    } while (0)
+#endif
+
+enum class EventKind : std::uint8_t {
+    Arrive,
+    // Starts running after another process (or nothing) was
+    Dispatch,
+    // Ran for `other` units
+    Run,
+    // Stopped running before finishing, for another process to run
+    Preempt,
+    Complete,
+    // From process `other` to this one
+    ContextSwitch,
+    // From CPU `other` to this one
+    Migrate,
+};
+
+const char* eventNames[] = { "chegada", "despacho", "execucao", "preempcao", "termino", "troca_de_contexto", "migracao" };
+
+struct SchedulerEvent {
+    int time;
+    EventKind kind;
+    int cpu;
+    int pid;
+    int other;
+};
+
+// Single-producer single-consumer ring: the scheduler pushes while a writer drains it from another thread, without locks. While it's full the scheduler yields to the writer instead of dropping events, so timelines are always complete
+class EventRing {
+private:
+    std::vector<SchedulerEvent> events;
+    std::size_t mask;
+    // Only written by the consumer and the producer, respectively
+    alignas(64) std::atomic<std::size_t> head{ 0 };
+    alignas(64) std::atomic<std::size_t> tail{ 0 };
+    long _stalls = 0;
+
+public:
+    // Capacity is rounded up to a power of two
+    explicit EventRing(const std::size_t& capacity) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        this->events.resize(size);
+        this->mask = size - 1;
+    }
+
+    // Times the producer found the ring full and had to wait
+    long stalls() const {
+        return this->_stalls;
+    }
+
+    void push(const SchedulerEvent& event) {
+        std::size_t tail = this->tail.load(std::memory_order_relaxed);
+
+        if (tail - this->head.load(std::memory_order_acquire) > this->mask) {
+            this->_stalls += 1;
+
+            while (tail - this->head.load(std::memory_order_acquire) > this->mask) {
+                std::this_thread::yield();
+            }
+        }
+
+        this->events[tail & this->mask] = event;
+        this->tail.store(tail + 1, std::memory_order_release);
+    }
+
+    bool pop(SchedulerEvent& event) {
+        std::size_t head = this->head.load(std::memory_order_relaxed);
+
+        if (head == this->tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        event = this->events[head & this->mask];
+        this->head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+};
+
+// What a CPU ran last, to tell dispatches, preemptions and context switches apart
+struct DispatchTracker {
+    int lastPid = -1;
+    bool lastFinished = true;
+
+    // Records a process running for `ticks` units from `time` on, and what that implies
+    void ran(EventRing* events, const int& time, const int& cpu, const int& pid, const int& ticks, const bool& finished) {
+        if (pid != this->lastPid) {
+            if (this->lastPid != -1 && !this->lastFinished) {
+                events->push({ time, EventKind::Preempt, cpu, this->lastPid, 0 });
+            }
+            if (this->lastPid != -1) {
+                events->push({ time, EventKind::ContextSwitch, cpu, pid, this->lastPid });
+            }
+
+            events->push({ time, EventKind::Dispatch, cpu, pid, 0 });
+        }
+
+        events->push({ time, EventKind::Run, cpu, pid, ticks });
+        if (finished) {
+            events->push({ time + ticks, EventKind::Complete, cpu, pid, 0 });
+        }
+
+        this->lastPid = pid;
+        this->lastFinished = finished;
+    }
+};
+
+// Drains a ring to a file on its own thread, either as a CSV timeline or as a Chrome trace (chrome://tracing or Perfetto), where each CPU is a track and consecutive runs of a process are a single slice
+class EventTraceWriter {
+private:
+    bool chrome;
+    std::ofstream output;
+    EventRing ring;
+    std::atomic<bool> stopping{ false };
+    std::thread thread;
+    bool first = true;
+    // Per CPU, the slice being built: its process, start and end
+    std::vector<SchedulerEvent> slices;
+    // Formatted by hand and written in large chunks, as streams can't keep up with the scheduler
+    std::string buffer;
+
+    void append(const char* text) {
+        this->buffer += text;
+    }
+
+    void append(const long& number) {
+        char digits[24];
+        this->buffer.append(digits, std::to_chars(digits, digits + sizeof(digits), number).ptr);
+    }
+
+    void flush() {
+        this->output.write(this->buffer.data(), this->buffer.size());
+        this->buffer.clear();
+    }
+
+    void separate() {
+        if (!this->first) {
+            this->append(",\n");
+        }
+        this->first = false;
+    }
+
+    void closeSlice(const int& cpu) {
+        const SchedulerEvent& slice = this->slices[cpu];
+        if (slice.pid == -1) {
+            return;
+        }
+
+        this->separate();
+        this->append("{\"name\":\"");
+        this->append(slice.pid);
+        this->append("\",\"ph\":\"X\",\"pid\":0,\"tid\":");
+        this->append(cpu);
+        this->append(",\"ts\":");
+        this->append(slice.time);
+        this->append(",\"dur\":");
+        this->append(slice.other - slice.time);
+        this->append("}");
+        this->slices[cpu].pid = -1;
+    }
+
+    void write(const SchedulerEvent& event) {
+        if (!this->chrome) {
+            this->append(event.time);
+            this->append(",");
+            this->append(eventNames[(int)event.kind]);
+            this->append(",");
+            this->append(event.cpu);
+            this->append(",");
+            this->append(event.pid);
+            this->append(",");
+            this->append(event.other);
+            this->append("\n");
+
+            return;
+        }
+
+        if (event.cpu >= (int)this->slices.size()) {
+            this->slices.resize(event.cpu + 1, { 0, EventKind::Run, 0, -1, 0 });
+        }
+
+        if (event.kind == EventKind::Run) {
+            SchedulerEvent& slice = this->slices[event.cpu];
+
+            // Runs that pick up right where the slice ends extend it
+            if (slice.pid != event.pid || slice.other != event.time) {
+                this->closeSlice(event.cpu);
+                slice = { event.time, EventKind::Run, event.cpu, event.pid, event.time };
+            }
+            slice.other += event.other;
+
+            return;
+        }
+
+        // Slices already show dispatches
+        if (event.kind == EventKind::Dispatch) {
+            return;
+        }
+
+        this->separate();
+        this->append("{\"name\":\"");
+        this->append(eventNames[(int)event.kind]);
+        this->append(" ");
+        this->append(event.pid);
+        this->append("\",\"ph\":\"i\",\"s\":\"t\",\"pid\":0,\"tid\":");
+        this->append(event.cpu);
+        this->append(",\"ts\":");
+        this->append(event.time);
+        this->append(",\"args\":{\"processo\":");
+        this->append(event.pid);
+        this->append(",\"outro\":");
+        this->append(event.other);
+        this->append("}}");
+    }
+
+    void drain() {
+        SchedulerEvent event;
+
+        while (!this->stopping.load(std::memory_order_acquire)) {
+            if (this->ring.pop(event)) {
+                this->write(event);
+
+                if (this->buffer.size() >= 1 << 20) {
+                    this->flush();
+                }
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+
+        // Whatever was pushed before stopping
+        while (this->ring.pop(event)) {
+            this->write(event);
+        }
+    }
+
+public:
+    // Chrome traces for paths ending in .json, CSV otherwise
+    EventTraceWriter(const std::string& path, const std::size_t& capacity = 1 << 20) : chrome(path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0), output(path), ring(capacity) {
+        if (!this->output) {
+            throw std::invalid_argument("Couldn't open " + path + " for writing.");
+        }
+
+        this->append(this->chrome ? "[\n" : "tempo,evento,cpu,processo,outro\n");
+        this->thread = std::thread(&EventTraceWriter::drain, this);
+    }
+    EventTraceWriter(const EventTraceWriter&) = delete;
+    EventTraceWriter& operator=(const EventTraceWriter&) = delete;
+
+    ~EventTraceWriter() {
+        this->stop();
+    }
+
+    EventRing* events() {
+        return &this->ring;
+    }
+
+    // Writes out everything that's left. Returns how many times the scheduler had to wait for the writer
+    long stop() {
+        if (this->thread.joinable()) {
+            this->stopping.store(true, std::memory_order_release);
+            this->thread.join();
+
+            if (this->chrome) {
+                for (int cpu = 0; cpu < (int)this->slices.size(); cpu++) {
+                    this->closeSlice(cpu);
+                }
+                this->append("\n]\n");
+            }
+            this->flush();
+            this->output.flush();
+        }
+
+        return this->ring.stalls();
+    }
+};
@@ -0,0 +1,419 @@
+#pragma once
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "./Queue.cpp"
+#include "./Scheduler.cpp"
+
+std::vector<std::string> supportedBalancers = { "global", "periodic", "stealing" };
+
+struct Processor {
+    Queue queue;
+    // Units it spent idle waiting to dispatch a process that had just arrived
+    int idleTime = 0;
+    // Units it spent running processes
+    long busyTime = 0;
+    // Process it ran last, -1 before it ran any
+    int lastPid = -1;
+    // Process it's switching to (-1 once it ran), and units until it's done
+    int switchingTo = -1;
+    int switchLeft = 0;
+#ifdef SCHEDULER_TRACING
+    DispatchTracker tracker;
+#endif
+};
+
+// Symmetric multiprocessor, each CPU with its own single-level run queue, all of them running the same policy. Processes move between CPUs according to the load balancer:
+//   global:   arrivals and processes whose quantum expired go to the least loaded CPU, and CPUs with nothing to run pull from the most loaded one, as if they all shared a single queue
+//   periodic: processes arrive at CPUs in turn, and every balancePeriod units they're moved from the most to the least loaded CPUs until they're even
+//   stealing: processes arrive at CPUs in turn, and CPUs with nothing to run steal from the next one that has something waiting
+// Processes pinned to a CPU always go to it and never migrate
+class MultiprocessorScheduler {
+private:
+    std::string balancer;
+    int balancePeriod = 0;
+    int _currentTime = 0;
+    int _migrations = 0;
+    long nextBalance = 0;
+    std::vector<Processor> cpus;
+    ProcessTable processes;
+    SchedulerStatistics _statistics;
+    SwitchCost switchCost = { 0, 0 };
+#ifdef SCHEDULER_TRACING
+    EventRing* events = nullptr;
+#endif
+
+    int load(const int& cpu) const {
+        return this->cpus[cpu].queue.remainingProcessCount();
+    }
+
+    int leastLoaded() const {
+        int best = 0;
+
+        for (int cpu = 1; cpu < (int)this->cpus.size(); cpu++) {
+            if (this->load(cpu) < this->load(best)) {
+                best = cpu;
+            }
+        }
+
+        return best;
+    }
+
+    int mostLoaded() const {
+        int best = 0;
+
+        for (int cpu = 1; cpu < (int)this->cpus.size(); cpu++) {
+            if (this->load(cpu) > this->load(best)) {
+                best = cpu;
+            }
+        }
+
+        return best;
+    }
+
+    // Where a process that's ready from `now` on goes, if it isn't pinned
+    int place(const int& slot) const {
+        if (this->processes.cpu[slot] != -1) {
+            return this->processes.cpu[slot];
+        }
+
+        return this->balancer == "global" ? this->leastLoaded() : this->processes.pid[slot] % this->cpus.size();
+    }
+
+    // Moves a process that was taken out of one CPU's queue to another's
+    void migrate(const int& slot, const int& from, const int& to, const int& now) {
+        // Its idle time is kept relative to the CPU it's in
+        this->processes.idleTime[slot] += this->cpus[to].idleTime - this->cpus[from].idleTime;
+        this->cpus[to].queue.add(slot, this->processes, now);
+
+        if (from != to) {
+            this->_migrations += 1;
+            TRACE_EVENT(this->events, now, EventKind::Migrate, to, this->processes.pid[slot], from);
+        }
+    }
+
+    // Gives a CPU with nothing to run something from another one's queue, if any has a process waiting that isn't pinned
+    void pull(const int& cpu) {
+        int cpusN = this->cpus.size();
+
+        if (this->balancer == "global") {
+            int from = this->mostLoaded();
+            int slot = this->cpus[from].queue.steal(this->processes);
+
+            if (slot != -1) {
+                this->migrate(slot, from, cpu, this->_currentTime);
+            }
+
+            return;
+        }
+
+        for (int i = 1; i < cpusN; i++) {
+            int from = (cpu + i) % cpusN;
+            int slot = this->cpus[from].queue.steal(this->processes);
+
+            if (slot != -1) {
+                this->migrate(slot, from, cpu, this->_currentTime);
+
+                return;
+            }
+        }
+    }
+
+    // Gives every CPU with nothing to run something from the others, if they have anything to spare
+    void pullIdle() {
+        for (int cpu = 0; cpu < (int)this->cpus.size(); cpu++) {
+            if (this->load(cpu) == 0) {
+                this->pull(cpu);
+            }
+        }
+    }
+
+    // Evens out the CPUs' queues, as far as pinned processes let it
+    void balance() {
+        while (true) {
+            int from = this->mostLoaded(), to = this->leastLoaded();
+            if (this->load(from) - this->load(to) <= 1) {
+                break;
+            }
+
+            int slot = this->cpus[from].queue.steal(this->processes);
+            if (slot == -1) {
+                break;
+            }
+
+            this->migrate(slot, from, to, this->_currentTime);
+        }
+    }
+
+    // Whether the CPU can't run anything this unit, as the process it would run has just arrived
+    bool dispatching(const int& cpu) const {
+        return this->_currentTime < 1 || this->processes.arrivalTime[this->cpus[cpu].queue.getCurrentProcess()] == this->_currentTime;
+    }
+
+    // Starts switching the CPU to the process it's about to run, if it ran another one last. Returns the units left until it's done switching
+    int switching(const int& cpu) {
+        Processor& processor = this->cpus[cpu];
+        int slot = processor.queue.getCurrentProcess();
+        int pid = this->processes.pid[slot];
+
+        if (pid != processor.switchingTo) {
+            processor.switchingTo = pid;
+            processor.switchLeft = processor.lastPid != -1 && pid != processor.lastPid ? this->switchCost.penalty(this->processes, slot) : 0;
+        }
+
+        return processor.switchLeft;
+    }
+
+    // Accounts for a process after it ran for `ticks` units on the given CPU, starting at the current time, giving back its slot if it's done
+    void account(const int& cpu, const int& slot, const int& ticks, const bool& done) {
+        // Response time goes from arrival to the first time it ran
+        if (this->processes.firstDispatch[slot] == -1) {
+            this->processes.firstDispatch[slot] = this->_currentTime;
+        }
+
+        if (!done) {
+            return;
+        }
+
+        // Everything but running or idling while it was in the system is waiting
+        int turnaroundTime = this->_currentTime + ticks - 1 - this->processes.arrivalTime[slot];
+        int waitingTime = turnaroundTime - this->processes.burstTime[slot] - (this->cpus[cpu].idleTime - this->processes.idleTime[slot]);
+
+        int responseTime = this->processes.firstDispatch[slot] - this->processes.arrivalTime[slot];
+
+        this->_statistics.finished(responseTime, turnaroundTime, waitingTime, this->_currentTime + ticks - 1);
+        this->processes.remove(slot);
+    }
+
+public:
+    // Constructors
+    MultiprocessorScheduler() {}
+    // Round-robin and aging queues take the first param as their quantum or aging period. Periodic balancing happens every balancePeriod units
+    MultiprocessorScheduler(const int& cpusN, const std::string& algorithm, const std::vector<int>& params, const std::string& balancer, const int& balancePeriod = 0) : balancer(balancer), balancePeriod(balancePeriod) {
+        if (cpusN < 1) {
+            throw std::invalid_argument("There must be at least one CPU.");
+        }
+
+        if (std::find(supportedBalancers.begin(), supportedBalancers.end(), balancer) == supportedBalancers.end()) {
+            throw std::invalid_argument("Only global, periodic and stealing load balancers are supported.");
+        }
+
+        if (balancer == "periodic" && balancePeriod <= 0) {
+            throw std::invalid_argument("Periodic load balancing needs a positive period.");
+        }
+
+        this->cpus.resize(cpusN);
+        for (Processor& cpu : this->cpus) {
+            cpu.queue = (algorithm == "rr" || algorithm == "aging") && !params.empty() ? Queue(algorithm, params.front()) : Queue(algorithm);
+        }
+    }
+
+    int cpusN() const {
+        return this->cpus.size();
+    }
+
+    int currentTime() const {
+        return this->_currentTime;
+    }
+
+    bool finished() const {
+        return std::all_of(this->cpus.begin(), this->cpus.end(), [](const Processor& cpu) { return cpu.queue.remainingProcessCount() == 0; });
+    }
+
+    // Priority is only used to order priority queues, there being a single level
+    void insert(const Process& process, const int&) {
+        if (process.cpu() < -1 || process.cpu() >= (int)this->cpus.size()) {
+            throw std::invalid_argument("Process is pinned to a CPU the scheduler doesn't have.");
+        }
+
+        // Initialize its statistics, relative to the CPU it goes to
+        int slot = this->processes.add(process, this->_currentTime, 0);
+
+        int cpu = this->place(slot);
+        TRACE_EVENT(this->events, this->_currentTime, EventKind::Arrive, cpu, process.getPid(), process.priority());
+
+        this->processes.idleTime[slot] = this->cpus[cpu].idleTime;
+        this->cpus[cpu].queue.add(slot, this->processes, this->_currentTime);
+    }
+
+    int levels() const {
+        return 1;
+    }
+
+    int migrations() const {
+        return this->_migrations;
+    }
+
+    // Share of the time until the last process finished that the CPU spent running processes
+    double utilization(const int& cpu) const {
+        int makespan = this->_statistics.makespan();
+
+        return makespan > 0 ? (double)this->cpus[cpu].busyTime / makespan : 0;
+    }
+
+    AverageTimes averageTimes() const {
+        return this->_statistics.averageTimes();
+    }
+
+    // Scheduler's averages followed by the number of migrations, then each CPU's utilization on its own line and, if detailed, the percentiles, overall utilization, throughput and context switches
+    void printStatistics(std::ostream& output = std::cout, const bool& detailed = false) {
+        AverageTimes averages = this->averageTimes();
+
+        output << precisionRound(averages.turnaroundTime, 1, "up") << " " << precisionRound(averages.responseTime, 1, "up") << " " << precisionRound(averages.waitingTime, 1, "up") << " " << this->_migrations << std::endl;
+
+        for (int cpu = 0; cpu < (int)this->cpus.size(); cpu++) {
+            output << "  " << cpu << " " << std::fixed << std::setprecision(4) << this->utilization(cpu) << std::defaultfloat << std::endl;
+        }
+
+        if (detailed) {
+            this->_statistics.print(output, this->cpus.size());
+        } else if (this->switchCost.dispatch > 0 || this->switchCost.warmup > 0) {
+            this->_statistics.printSwitches(output);
+        }
+    }
+
+    void setSwitchCost(const SwitchCost& switchCost) {
+        if (switchCost.dispatch < 0 || switchCost.warmup < 0) {
+            throw std::invalid_argument("Context switch costs can't be negative.");
+        }
+
+        this->switchCost = switchCost;
+    }
+
+    const SchedulerStatistics& statistics() const {
+        return this->_statistics;
+    }
+
+    // Simulates every time unit before `until` on every CPU in lockstep, jumping straight to the next moment any of them finishes a process, has its quantum expire or gets preempted, or to the next balancing. No process may arrive before `until`
+    void advance(const int& until) {
+        int cpusN = this->cpus.size();
+        std::vector<int> expired;
+
+        while (this->_currentTime < until) {
+            if (this->balancer == "periodic" && this->_currentTime >= this->nextBalance) {
+                this->balance();
+                this->nextBalance = ((long)this->_currentTime / this->balancePeriod + 1) * this->balancePeriod;
+            } else if (this->balancer != "periodic") {
+                this->pullIdle();
+            }
+
+            for (Processor& processor : this->cpus) {
+                // Aging doesn't take the CPU from a process it's switching to before it gets to run, or switches could go on forever
+                if (processor.queue.remainingProcessCount() > 0 && processor.switchingTo == -1) {
+                    processor.queue.schedule(this->processes, this->_currentTime);
+                }
+            }
+            // Preempted processes wait in their CPU's queue, where an idle CPU can take them right away
+            if (this->balancer != "periodic") {
+                this->pullIdle();
+            }
+
+            // Stop at the next balancing too
+            long limit = this->balancer == "periodic" ? std::min((long)until, this->nextBalance) : until;
+            int ticks = limit - this->_currentTime;
+            bool idle = true;
+
+            for (int cpu = 0; cpu < cpusN; cpu++) {
+                Queue& queue = this->cpus[cpu].queue;
+                if (queue.remainingProcessCount() == 0) {
+                    continue;
+                }
+
+                idle = false;
+                if (this->dispatching(cpu)) {
+                    ticks = std::min(ticks, 1);
+                } else {
+                    int switchLeft = this->switching(cpu);
+                    ticks = std::min(ticks, switchLeft > 0 ? switchLeft : queue.runLength(ticks, this->processes, this->_currentTime));
+                }
+            }
+
+            // Nothing to run until something arrives
+            if (idle) {
+                this->_currentTime = until;
+
+                // Balancing empty CPUs does nothing, so skip the ones in between
+                if (this->balancer == "periodic" && this->nextBalance < until) {
+                    this->nextBalance = ((long)until + this->balancePeriod - 1) / this->balancePeriod * this->balancePeriod;
+                }
+
+                break;
+            }
+
+            for (int cpu = 0; cpu < cpusN; cpu++) {
+                Processor& processor = this->cpus[cpu];
+                if (processor.queue.remainingProcessCount() == 0) {
+                    continue;
+                }
+
+                // Only run execution logic after the initial second or on the second after a process arrives
+                if (this->dispatching(cpu)) {
+                    if (this->_currentTime >= 1) {
+                        processor.idleTime += 1;
+                    }
+
+                    continue;
+                }
+
+                // Switching to another process takes the CPU's time before the process gets to run
+                if (processor.switchLeft > 0) {
+                    processor.switchLeft -= ticks;
+                    this->_statistics.switching(ticks);
+
+                    continue;
+                }
+
+                int slot = processor.queue.getCurrentProcess();
+                int pid = this->processes.pid[slot];
+                RunOutcome outcome;
+                int ran = processor.queue.run(ticks, this->processes, outcome, this->_currentTime);
+                processor.busyTime += ran;
+                this->_statistics.ran(pid, processor.lastPid, ran);
+                processor.lastPid = pid;
+                processor.switchingTo = -1;
+
+                if (outcome == RunOutcome::Expired) {
+                    expired.push_back(cpu);
+                    expired.push_back(slot);
+                }
+
+                this->account(cpu, slot, ran, outcome == RunOutcome::Finished);
+#ifdef SCHEDULER_TRACING
+                if (this->events != nullptr) {
+                    processor.tracker.ran(this->events, this->_currentTime, cpu, pid, ran, outcome == RunOutcome::Finished);
+                }
+#endif
+            }
+
+            // Processes that used up their quantum go back once every CPU ran, so none of them runs twice in the same units
+            for (int i = 0; i < (int)expired.size(); i += 2) {
+                int from = expired[i], slot = expired[i + 1];
+
+                if (this->balancer == "global" && this->processes.cpu[slot] == -1) {
+                    this->migrate(slot, from, this->leastLoaded(), this->_currentTime + ticks);
+                } else {
+                    this->cpus[from].queue.add(slot, this->processes, this->_currentTime + ticks);
+                }
+            }
+            expired.clear();
+
+            this->_currentTime += ticks;
+        }
+    }
+
+    void tick() {
+        this->advance(this->_currentTime + 1);
+    }
+
+#ifdef SCHEDULER_TRACING
+    // Records every event from now on to the given ring, if it's not null
+    void traceTo(EventRing* events) {
+        this->events = events;
+    }
+#endif
+};
@@ -1,24 +1,38 @@
+#pragma once
+
 #include <string>
 
 #include "../utils/uuid.cpp"
 
 class Process {
 private:
-    std::string _pid = uuid_v4();
-    int _timeLeft;
+    // CPU it's pinned to, -1 for any
+    int _cpu;
+    int _pid;
+    int _peakTime;
+    int _priority;
 
 public:
-    explicit Process(const int& peakTime) : _timeLeft(peakTime) {}
+    Process(const int& pid, const int& peakTime, const int& priority = 0, const int& cpu = -1) : _cpu(cpu), _pid(pid), _peakTime(peakTime), _priority(priority) {}
+
+    const int& cpu() const {
+        return this->_cpu;
+    }
 
-    const std::string& getPid() const {
+    const int& getPid() const {
         return this->_pid;
     }
 
-    const int& timeLeft() const {
-        return this->_timeLeft;
+    const int& peakTime() const {
+        return this->_peakTime;
+    }
+
+    const int& priority() const {
+        return this->_priority;
     }
 
-    void reduceTime(const int& time = 1) {
-        this->_timeLeft -= time;
+    // Only generated when asked for, always the same for a given pid
+    std::string uuid() const {
+        return uuid_v4(this->_pid);
     }
 };
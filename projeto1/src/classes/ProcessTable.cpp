@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "./Process.cpp"
+
+// Per-process state of a scheduler, with one contiguous array per field. Processes get a slot in them when they arrive and give it back when they finish, so the table only grows as large as the most processes ever in the system at once, however long the trace is. Queues hold slots
+class ProcessTable {
+private:
+    // Slots given back, reused before the table grows
+    std::vector<int> freeSlots;
+
+public:
+    std::vector<int> arrivalTime;
+    std::vector<int> burstTime;
+    // CPU the process is pinned to, -1 for any
+    std::vector<int> cpu;
+    // When it first got the CPU, -1 until it does
+    std::vector<int> firstDispatch;
+    // Scheduler's idle time when the process arrived
+    std::vector<int> idleTime;
+    std::vector<int> pid;
+    // Static priority, 0 being the highest
+    std::vector<int> priority;
+    std::vector<int> timeLeft;
+
+    // Returns the process' slot
+    int add(const Process& process, const int& arrivalTime, const int& idleTime) {
+        int slot;
+
+        if (!this->freeSlots.empty()) {
+            slot = this->freeSlots.back();
+            this->freeSlots.pop_back();
+        } else {
+            slot = this->timeLeft.size();
+
+            this->arrivalTime.push_back(0);
+            this->burstTime.push_back(0);
+            this->cpu.push_back(0);
+            this->firstDispatch.push_back(0);
+            this->idleTime.push_back(0);
+            this->pid.push_back(0);
+            this->priority.push_back(0);
+            this->timeLeft.push_back(0);
+        }
+
+        this->arrivalTime[slot] = arrivalTime;
+        this->burstTime[slot] = process.peakTime();
+        this->cpu[slot] = process.cpu();
+        this->firstDispatch[slot] = -1;
+        this->idleTime[slot] = idleTime;
+        this->pid[slot] = process.getPid();
+        this->priority[slot] = process.priority();
+        this->timeLeft[slot] = process.peakTime();
+
+        return slot;
+    }
+
+    // Gives back the slot of a process that finished
+    void remove(const int& slot) {
+        this->freeSlots.push_back(slot);
+    }
+};
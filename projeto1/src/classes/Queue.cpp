@@ -1,19 +1,50 @@
+#pragma once
+
 #include <algorithm>
+#include <functional>
 #include <stdexcept>
 #include <string>
 #include <unistd.h>
 #include <vector>
 
-#include "./Process.cpp"
+#include "./ProcessTable.cpp"
+#include "./RingBuffer.cpp"
+
+std::vector<std::string> supportedAlgorithms = { "fcfs", "rr", "sjf", "srtf", "priority", "aging" };
+const char* unsupportedAlgorithmMessage = "Only FCFS, SJF, SRTF, RR, priority and aging are supported.";
+
+// What happened to the process a queue just ran
+enum class RunOutcome {
+    Running,
+    Finished,
+    // Its quantum expired and it left the queue, so the scheduler must put it back somewhere
+    Expired,
+};
+
+// Entry of SJF, SRTF and priority queues' heap, ordered by key (time left or priority) and then by arrival in the queue
+struct HeapEntry {
+    long key;
+    long order;
+    int slot;
 
-std::vector<std::string> supportedAlgorithms = { "fcfs", "rr", "sjf" };
-const char* unsupportedAlgorithmMessage = "Only FCFS, SJF and RR are supported.";
+    bool operator>(const HeapEntry& other) const {
+        return this->key != other.key ? this->key > other.key : this->order > other.order;
+    }
+};
 
 class Queue {
 private:
     std::string algorithm = "";
+    // Units a process has to wait to go up a priority (aging only)
+    int agingPeriod = 0;
+    // Non-preemptive SJF and priority queues keep the process they're running out of the heap
+    int current = -1;
+    // SJF, SRTF and priority queues' min-heap
+    std::vector<HeapEntry> heap;
+    long insertions = 0;
     bool preemptive = false;
-    std::vector<Process> processes;
+    // FCFS and RR's processes, by their slot in the process table, in the order they will run
+    RingBuffer<int> processes;
     int quantum = 0;
     bool running = false;
     int timeSinceSwitch = 0;
@@ -24,23 +55,95 @@ private:
         }
     }
 
-    void removeProcess() {
-        this->processes.erase(this->processes.begin());
+    bool usesHeap() const {
+        return this->algorithm == "sjf" || this->algorithm == "priority" || this->algorithm == "aging";
+    }
+
+    bool byPriority() const {
+        return this->algorithm == "priority" || this->algorithm == "aging";
+    }
+
+    // Heap key of the process if it had been ready since `now`. With aging, it goes up a priority for every agingPeriod units it waits, which keeps the heap's order as all waiting processes age at the same rate
+    long key(const int& slot, const ProcessTable& table, const int& now) const {
+        if (this->algorithm == "sjf") {
+            return table.timeLeft[slot];
+        } else if (this->algorithm == "aging") {
+            return (long)table.priority[slot] * this->agingPeriod + now;
+        }
+
+        return table.priority[slot];
     }
 
-    void sort(const int& startIndex = 0, const std::string order = "asc") {
-        if (order != "asc" && order != "desc") {
-            throw std::invalid_argument("Sorting must be done ascendingly or descendingly.");
+    // Removes the heap entry at the given index, keeping it a heap
+    void eraseHeap(std::size_t index) {
+        this->heap[index] = this->heap.back();
+        this->heap.pop_back();
+
+        std::size_t size = this->heap.size();
+        if (index >= size) {
+            return;
+        }
+
+        // It may belong either above or below where the removed entry was
+        while (index > 0 && this->heap[(index - 1) / 2] > this->heap[index]) {
+            std::swap(this->heap[index], this->heap[(index - 1) / 2]);
+            index = (index - 1) / 2;
         }
 
-        // Sort in ascending order
-        std::sort(
-            processes.begin() + startIndex,
-            processes.end(),
-            [order](const Process& a, const Process& b) {
-                return order == "asc" ? a.timeLeft() < b.timeLeft() : a.timeLeft() > b.timeLeft();
+        for (std::size_t child = 2 * index + 1; child < size; child = 2 * index + 1) {
+            if (child + 1 < size && this->heap[child] > this->heap[child + 1]) {
+                child += 1;
             }
-        );
+            if (!(this->heap[index] > this->heap[child])) {
+                break;
+            }
+
+            std::swap(this->heap[index], this->heap[child]);
+            index = child;
+        }
+    }
+
+    // Key the running process is compared against. Aging only lets a waiting process take over once it went up a whole priority above it
+    long runningKey(const ProcessTable& table, const int& now) const {
+        long key = this->key(this->current, table, now);
+
+        return this->algorithm == "aging" ? key - this->agingPeriod + 1 : key;
+    }
+
+    void pushHeap(const int& slot, const ProcessTable& table, const int& now) {
+        this->heap.push_back({ this->key(slot, table, now), this->insertions, slot });
+        std::push_heap(this->heap.begin(), this->heap.end(), std::greater<HeapEntry>());
+        this->insertions += 1;
+    }
+
+    // Puts the best waiting process in place of the running one if it (now) has a higher priority, or if none is running
+    void dispatch(const ProcessTable& table, const int& now) {
+        if (this->current != -1 && (this->heap.empty() || this->heap.front().key >= this->runningKey(table, now))) {
+            return;
+        }
+
+        int next = this->heap.front().slot;
+        this->popHeap();
+
+        if (this->current != -1) {
+            this->pushHeap(this->current, table, now);
+        }
+        this->current = next;
+    }
+
+    void popHeap() {
+        std::pop_heap(this->heap.begin(), this->heap.end(), std::greater<HeapEntry>());
+        this->heap.pop_back();
+    }
+
+    void removeProcess() {
+        if (!this->usesHeap()) {
+            this->processes.pop_front();
+        } else if (this->current != -1) {
+            this->current = -1;
+        } else {
+            this->popHeap();
+        }
     }
 
 public:
@@ -51,75 +154,221 @@ public:
 
         if (algorithm == "rr") {
             throw std::invalid_argument("Round-robin queues need a quantum parameter. Please provide one.");
+        } else if (algorithm == "aging") {
+            throw std::invalid_argument("Aging queues need an aging period parameter. Please provide one.");
         }
 
+        // Shortest remaining time first is preemptive SJF
+        if (algorithm == "srtf") {
+            this->algorithm = "sjf";
+            this->preemptive = true;
+        }
     }
     explicit Queue(const std::string& algorithm, const bool& preemptive) : algorithm(algorithm), preemptive(preemptive) {
         if (algorithm != "sjf") {
             throw std::invalid_argument("Only SJF queues may be preemptive.");
         }
     }
-    Queue(const std::string& algorithm, const int quantum) : algorithm(algorithm), quantum(quantum) {
-        if (algorithm != "rr") {
-            throw std::invalid_argument("Only round-robin queues need a quantum parameter.");
+    // Round-robin's quantum or aging's period
+    Queue(const std::string& algorithm, const int param) : algorithm(algorithm) {
+        if (algorithm == "rr") {
+            if (param <= 0) {
+                throw std::invalid_argument("Round-robin quantum must be positive.");
+            }
+
+            this->quantum = param;
+        } else if (algorithm == "aging") {
+            if (param <= 0) {
+                throw std::invalid_argument("Aging period must be positive.");
+            }
+
+            this->agingPeriod = param;
+        } else {
+            throw std::invalid_argument("Only round-robin and aging queues take a parameter.");
         }
     }
 
-    void add(const Process& process) {
-        this->processes.push_back(process);
+    // Adds a process that's ready from `now` on. A higher priority one preempts the running process
+    void add(const int& slot, const ProcessTable& table, const int& now) {
+        if (!this->usesHeap()) {
+            this->processes.push_back(slot);
 
-        if (this->algorithm == "sjf") {
-            sort(!preemptive && running ? 1 : 0);
+            return;
+        }
+
+        this->pushHeap(slot, table, now);
+
+        if (this->byPriority() && this->current != -1) {
+            this->dispatch(table, now);
         }
     }
 
-    std::string getCurrentProcess() {
-        return this->processes.front().getPid();
+    int getCurrentProcess() const {
+        if (!this->usesHeap()) {
+            return this->processes.front();
+        }
+
+        return this->current != -1 ? this->current : this->heap.front().slot;
+    }
+
+    // Slots of the processes in the order they will run (as long as nothing else arrives)
+    std::vector<int> getProcesses() const {
+        std::vector<int> slots;
+
+        if (!this->usesHeap()) {
+            for (std::size_t i = 0; i < this->processes.size(); i++) {
+                slots.push_back(this->processes[i]);
+            }
+
+            return slots;
+        }
+
+        std::vector<HeapEntry> sorted = this->heap;
+        std::sort(sorted.begin(), sorted.end(), [](const HeapEntry& a, const HeapEntry& b) { return b > a; });
+
+        if (this->current != -1) {
+            slots.push_back(this->current);
+        }
+        for (const HeapEntry& entry : sorted) {
+            slots.push_back(entry.slot);
+        }
+
+        return slots;
+    }
+
+    int remainingProcessCount() const {
+        if (!this->usesHeap()) {
+            return this->processes.size();
+        }
+
+        return this->heap.size() + (this->current != -1 ? 1 : 0);
     }
 
-    std::vector<Process> getProcesses() {
-        return this->processes;
+    // Removes every process, returning them in the order they would have run
+    std::vector<int> clear() {
+        std::vector<int> slots = this->getProcesses();
+
+        this->current = -1;
+        this->heap.clear();
+        this->processes = RingBuffer<int>();
+        this->running = false;
+        this->timeSinceSwitch = 0;
+
+        return slots;
     }
 
-    int remainingProcessCount() {
-        return this->processes.size();
+    // Lets a waiting process that (now) has a higher priority take the running one's place. Only priority queues have to be told time went by
+    void schedule(const ProcessTable& table, const int& now) {
+        if (this->byPriority() && !this->heap.empty()) {
+            this->dispatch(table, now);
+        }
     }
 
-    bool tick() {
-        if (!running) {
+    // Units run() would run the current process for, up to maxTicks, as of the last schedule()
+    int runLength(const int& maxTicks, const ProcessTable& table, const int& now) const {
+        int ticks = std::min(maxTicks, table.timeLeft[this->getCurrentProcess()]);
+
+        if (this->algorithm == "rr") {
+            ticks = std::min(ticks, this->quantum - this->timeSinceSwitch);
+        } else if (this->algorithm == "aging" && !this->heap.empty()) {
+            // Its key grows while it runs, as if it was ready from each unit on, until the best waiting one's is smaller
+            long overtaken = this->heap.front().key - this->runningKey(table, now) + 1;
+            ticks = std::min((long)ticks, std::max(overtaken, 1L));
+        }
+
+        return ticks;
+    }
+
+    // Takes a waiting process that isn't pinned to a CPU out of the queue. Returns its slot, or -1 if there's none
+    int steal(const ProcessTable& table) {
+        if (!this->usesHeap()) {
+            // Looking from the one that would run last, as the front one is running, or about to
+            for (int i = this->processes.size() - 1; i > 0; i--) {
+                int slot = this->processes[i];
+
+                if (table.cpu[slot] == -1) {
+                    this->processes.erase(i);
+
+                    return slot;
+                }
+            }
+
+            return -1;
+        }
+
+        // The heap's array isn't in run order, so this gives up the last entry in it instead: a leaf, which runs after every entry above it but not necessarily last. Unless it's kept apart, the top of the heap is running or about to
+        int first = this->current == -1 ? 1 : 0;
+        for (int i = this->heap.size() - 1; i >= first; i--) {
+            int slot = this->heap[i].slot;
+
+            if (table.cpu[slot] == -1) {
+                this->eraseHeap(i);
+
+                return slot;
+            }
+        }
+
+        return -1;
+    }
+
+    // Runs the current process for up to maxTicks time units starting at `now`, stopping early if it finishes, its quantum expires or (with aging) a waiting process gets a higher priority. Returns how many units it ran for
+    int run(const int& maxTicks, ProcessTable& table, RunOutcome& outcome, const int& now) {
+        if (this->byPriority()) {
+            if (this->current == -1) {
+                this->dispatch(table, now);
+            }
+        } else if (!running) {
             this->running = true;
+
+            // Once it starts running, a non-preemptive process can't be overtaken anymore
+            if (this->algorithm == "sjf" && !this->preemptive) {
+                this->current = this->heap.front().slot;
+                this->popHeap();
+            }
         }
-        this->processes.front().reduceTime();
+
+        int& timeLeft = table.timeLeft[this->getCurrentProcess()];
+        int ticks = this->runLength(maxTicks, table, now);
+
+        timeLeft -= ticks;
 
         // If the process is done
-        if (this->processes.front().timeLeft() == 0) {
+        if (timeLeft == 0) {
             // Remove it from the queue
             this->removeProcess();
 
-            if (this->algorithm == "sjf") {
+            if (this->usesHeap()) {
                 this->running = false;
             } else if (this->algorithm == "rr") {
                 // Reset time since switch, otherwise the next process won't use all its quantum
                 this->timeSinceSwitch = 0;
             }
 
-            return true;
+            outcome = RunOutcome::Finished;
+            return ticks;
+        }
+
+        // A preemptive process stays on top of the heap, as it only got shorter
+        if (this->algorithm == "sjf" && this->current == -1) {
+            this->heap.front().key = timeLeft;
         }
 
         if (this->algorithm == "rr") {
-            this->timeSinceSwitch += 1;
+            this->timeSinceSwitch += ticks;
 
             // If the process has spent all its available time (quantum)
             if (this->timeSinceSwitch >= this->quantum) {
-                // Push it to the end of the queue
-                this->processes.push_back(this->processes.front());
                 // Stop its execution
                 this->removeProcess();
                 // And reset time since switch
                 this->timeSinceSwitch = 0;
+
+                outcome = RunOutcome::Expired;
+                return ticks;
             }
         }
 
-        return false;
+        outcome = RunOutcome::Running;
+        return ticks;
     }
 };
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// FIFO with O(1) push and pop, doubling its capacity whenever it fills up
+template <typename T>
+class RingBuffer {
+private:
+    // Capacity is always a power of two, so wrapping around is a mask
+    std::vector<T> items;
+    std::size_t head = 0;
+    std::size_t _size = 0;
+
+    void grow() {
+        std::vector<T> grown(this->items.empty() ? 16 : this->items.size() * 2);
+
+        for (std::size_t i = 0; i < this->_size; i++) {
+            grown[i] = (*this)[i];
+        }
+
+        this->items.swap(grown);
+        this->head = 0;
+    }
+
+public:
+    const T& operator[](const std::size_t& index) const {
+        return this->items[(this->head + index) & (this->items.size() - 1)];
+    }
+
+    bool empty() const {
+        return this->_size == 0;
+    }
+
+    const T& front() const {
+        return this->items[this->head];
+    }
+
+    // Shifts every item after it one place forward, so it's O(1) at the back
+    void erase(const std::size_t& index) {
+        for (std::size_t i = index; i + 1 < this->_size; i++) {
+            this->items[(this->head + i) & (this->items.size() - 1)] = (*this)[i + 1];
+        }
+
+        this->_size -= 1;
+    }
+
+    void pop_front() {
+        this->head = (this->head + 1) & (this->items.size() - 1);
+        this->_size -= 1;
+    }
+
+    // Taken by value, as it may be one of our own items and growing would invalidate it
+    void push_back(const T item) {
+        if (this->_size == this->items.size()) {
+            this->grow();
+        }
+
+        this->items[(this->head + this->_size) & (this->items.size() - 1)] = item;
+        this->_size += 1;
+    }
+
+    std::size_t size() const {
+        return this->_size;
+    }
+};
@@ -1,165 +1,285 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
-#include <map>
 #include <stdexcept>
 #include <string>
 #include <unistd.h>
 #include <vector>
 
+#include "./EventTrace.cpp"
 #include "./Queue.cpp"
+#include "./SchedulerStatistics.cpp"
 #include "../utils/precisionRound.cpp"
 
-struct AverageTimes {
-    float responseTime;
-    float turnaroundTime;
-    float waitingTime;
-};
+// Units a CPU loses switching from one process to another, before the new one gets to run
+struct SwitchCost {
+    // Saving and restoring state, paid on every context switch
+    int dispatch;
+    // Refilling caches, only paid by processes that had already run, as a process' first run starts cold anyway
+    int warmup;
 
-struct ProcessInfo {
-    int arrivalTime;
-    int responseTime;
-    int turnaroundTime;
-    int waitingTime;
+    int penalty(const ProcessTable& processes, const int& slot) const {
+        return this->dispatch + (processes.timeLeft[slot] < processes.burstTime[slot] ? this->warmup : 0);
+    }
 };
 
-// Currently supports a single queue.
+// Multilevel queue scheduler, level 0 being the highest priority. Supports up to 64 levels
 class Scheduler {
 private:
-    AverageTimes averages = { 0, 0, 0 };
+    // Period of the priority boost that moves every process back to the top level (0 for none)
+    int boostPeriod = 0;
     int _currentTime = 0;
-    std::map<std::string, ProcessInfo> processInfo;
+    // Whether processes that use up their quantum get demoted to the next level
+    bool feedback = false;
+    // Units the CPU spent idle waiting to dispatch a process that had just arrived
+    int idleTime = 0;
+    // Process that ran last, -1 before any did
+    int lastPid = -1;
+    long nextBoost = 0;
+    // Bit i is set when level i has processes in it
+    std::uint64_t nonEmptyLevels = 0;
+    ProcessTable processes;
     std::vector<Queue> queues;
+    SchedulerStatistics _statistics;
+    SwitchCost switchCost = { 0, 0 };
+    // Process the CPU is switching to (-1 once it ran), and units until it's done
+    int switchingTo = -1;
+    int switchLeft = 0;
+#ifdef SCHEDULER_TRACING
+    EventRing* events = nullptr;
+    DispatchTracker tracker;
+#endif
 
-public:
-    // Constructor
-    Scheduler() {}
-    Scheduler(const std::vector<std::string>& algorithms) : queues(algorithms.size()) {
-        int queuesN = algorithms.size();
+    // Moves every process in the lower levels back to the top one
+    void boost() {
+        for (int level = 1; level < (int)this->queues.size(); level++) {
+            for (int slot : this->queues[level].clear()) {
+                this->queues[0].add(slot, this->processes, this->_currentTime);
+            }
 
-        // Populate the queues array
-        for (int i = 0; i < queuesN; i++) {
-            queues[i] = Queue(algorithms[i]);
+            this->updateLevel(level);
         }
+
+        this->updateLevel(0);
     }
-    Scheduler(const std::vector<std::string>& algorithms, std::vector<int> params) : queues(algorithms.size()) {
-        int queuesN = algorithms.size();
 
-        // Populate the queues array
-        for (int i = 0; i < queuesN; i++) {
-            queues[i] = Queue(algorithms[i], params.front());
-            params.erase(params.begin());
+    void updateLevel(const int& level) {
+        if (this->queues[level].remainingProcessCount() > 0) {
+            this->nonEmptyLevels |= (std::uint64_t)1 << level;
+        } else {
+            this->nonEmptyLevels &= ~((std::uint64_t)1 << level);
         }
     }
 
-    // Copy constructor
-    Scheduler(const Scheduler& other) {
-        for (Queue queue : other.queues) {
-            this->queues.push_back(queue);
+    // Accounts for the running process after it ran for `ticks` units starting at the current time, giving back its slot if it's done
+    void account(const int& slot, const int& ticks, const bool& done) {
+        // Response time goes from arrival to the first time it ran
+        if (this->processes.firstDispatch[slot] == -1) {
+            this->processes.firstDispatch[slot] = this->_currentTime;
         }
+
+        if (!done) {
+            return;
+        }
+
+        // Everything but running or idling while it was in the system is waiting
+        int turnaroundTime = this->_currentTime + ticks - 1 - this->processes.arrivalTime[slot];
+        int waitingTime = turnaroundTime - this->processes.burstTime[slot] - (this->idleTime - this->processes.idleTime[slot]);
+
+        int responseTime = this->processes.firstDispatch[slot] - this->processes.arrivalTime[slot];
+
+        this->_statistics.finished(responseTime, turnaroundTime, waitingTime, this->_currentTime + ticks - 1);
+        this->processes.remove(slot);
     }
 
-    // Copy assignment
-    Scheduler& operator=(const Scheduler& other) {
-        if (this != &other) {
-            this->queues = other.queues;
+public:
+    // Constructors
+    Scheduler() {}
+    Scheduler(const std::vector<std::string>& algorithms) : Scheduler(algorithms, {}) {}
+    // Each round-robin or aging queue takes the next of the given quantums or aging periods
+    Scheduler(const std::vector<std::string>& algorithms, std::vector<int> params) : queues(algorithms.size()) {
+        int queuesN = algorithms.size();
+
+        if (queuesN > 64) {
+            throw std::invalid_argument("Only up to 64 queues are supported.");
         }
 
-        return *this;
+        // Populate the queues array
+        for (int i = 0; i < queuesN; i++) {
+            if ((algorithms[i] == "rr" || algorithms[i] == "aging") && !params.empty()) {
+                queues[i] = Queue(algorithms[i], params.front());
+                params.erase(params.begin());
+            } else {
+                queues[i] = Queue(algorithms[i]);
+            }
+        }
+    }
+    // Multilevel feedback queue
+    Scheduler(const std::vector<std::string>& algorithms, const std::vector<int>& params, const bool& feedback, const int& boostPeriod = 0) : Scheduler(algorithms, params) {
+        if (boostPeriod < 0) {
+            throw std::invalid_argument("Priority boost period can't be negative.");
+        }
+
+        this->boostPeriod = boostPeriod;
+        this->feedback = feedback;
+        this->nextBoost = boostPeriod;
     }
 
     int currentTime() {
         return this->_currentTime;
     }
 
-    bool finished() {
-        for (Queue queue : queues) {
-            if (queue.remainingProcessCount() > 0) {
-                return false;
-            }
-        }
-
-        return true;
+    bool finished() const {
+        return this->nonEmptyLevels == 0;
     }
 
-    void insert(Process& process, int priority) {
+    void insert(const Process& process, int priority) {
         if (priority < 0 || priority >= (int)queues.size()) {
             throw std::invalid_argument("Given priority is higher than the number of available queues.");
         }
 
-        // Add to requested queue
-        this->queues[priority].add(process);
+        // Initialize its statistics
+        int slot = this->processes.add(process, this->_currentTime, this->idleTime);
 
-        // std::cout << process.getPid() << std::endl;
+        // std::cout << process.uuid() << std::endl;
         // std::cout << this->_currentTime << std::endl;
 
-        // And initialize its statistics (-1 is a workaround after the separation of main and scheduler)
-        ProcessInfo info = { this->_currentTime, -this->_currentTime, -this->_currentTime, this->_currentTime > 0 ? -1 : 0 };
-        this->processInfo[process.getPid()] = info;
-    }
+        TRACE_EVENT(this->events, this->_currentTime, EventKind::Arrive, 0, process.getPid(), priority);
 
-    void printStatistics() {
-        int processesN = this->processInfo.size();
+        // And add it to the requested queue
+        this->queues[priority].add(slot, this->processes, this->_currentTime);
+        this->updateLevel(priority);
+    }
 
-        // Calculate average times
-        for (auto info : this->processInfo) {
-            // std::cout << info.second.waitingTime << std::endl;
-            this->averages.responseTime += (float)info.second.responseTime / processesN;
-            this->averages.turnaroundTime += (float)info.second.turnaroundTime / processesN;
-            this->averages.waitingTime += (float)info.second.waitingTime / processesN;
-        }
+    int levels() const {
+        return this->queues.size();
+    }
 
-        std::cout << precisionRound(this->averages.turnaroundTime, 1, "up") << " " << precisionRound(this->averages.responseTime, 1, "up") << " " << precisionRound(this->averages.waitingTime, 1, "up") << " " << std::endl;
+    AverageTimes averageTimes() const {
+        return this->_statistics.averageTimes();
     }
 
-    void tick() {
-        int currentQueue = 0;
+    // Averages and, if detailed, their percentiles, utilization, throughput and context switches on the following lines
+    void printStatistics(std::ostream& output = std::cout, const bool& detailed = false) {
+        AverageTimes averages = this->averageTimes();
 
-        // Only run execution logic after the initial second or on the second after a process arrives
-        if (this->_currentTime < 1 || queues[currentQueue].remainingProcessCount() == 0 || this->processInfo[queues[currentQueue].getCurrentProcess()].arrivalTime == this->_currentTime) {
-            this->_currentTime += 1;
+        output << precisionRound(averages.turnaroundTime, 1, "up") << " " << precisionRound(averages.responseTime, 1, "up") << " " << precisionRound(averages.waitingTime, 1, "up") << " " << std::endl;
 
-            return;
+        if (detailed) {
+            this->_statistics.print(output);
+        } else if (this->switchCost.dispatch > 0 || this->switchCost.warmup > 0) {
+            this->_statistics.printSwitches(output);
         }
+    }
 
-        std::string currentProcess = queues[currentQueue].getCurrentProcess();
-        bool done = queues[currentQueue].tick();
+    void setSwitchCost(const SwitchCost& switchCost) {
+        if (switchCost.dispatch < 0 || switchCost.warmup < 0) {
+            throw std::invalid_argument("Context switch costs can't be negative.");
+        }
 
-        // std::cout << currentProcess << " tick" << std::endl;
+        this->switchCost = switchCost;
+    }
 
-        // For all processes that the scheduler has taken care of
-        for (auto procInfo : this->processInfo) {
-            std::string pid = procInfo.first;
+    const SchedulerStatistics& statistics() const {
+        return this->_statistics;
+    }
 
-            // If it already finished, skip it
-            if (processInfo[pid].turnaroundTime > 0) {
-                continue;
+    // Simulates every time unit before `until`, jumping straight to the next completion, quantum expiry or priority boost instead of going one unit at a time. No process may arrive before `until`
+    void advance(const int& until) {
+        while (this->_currentTime < until) {
+            if (this->boostPeriod > 0 && this->_currentTime >= this->nextBoost) {
+                this->boost();
+                this->nextBoost = ((long)this->_currentTime / this->boostPeriod + 1) * this->boostPeriod;
             }
 
-            // std::cout << pid << ", atual: " << currentProcess << std::endl;
-
-            // If this is the running process
-            if (pid == currentProcess) {
-                // And it just finished
-                if (done) {
-                    // Calculate turnaround time
-                    processInfo[pid].turnaroundTime += this->_currentTime;
-                    // std::cout << pid << " finish: " << this->_currentTime << std::endl;
-                    // std::cout << pid << " turn: " << processInfo[pid].turnaroundTime << std::endl;
-                    continue;
+            // Nothing to run until something arrives
+            if (this->nonEmptyLevels == 0) {
+                this->_currentTime = until;
+
+                // Boosting an empty scheduler does nothing, so skip the ones in between
+                if (this->boostPeriod > 0 && this->nextBoost < until) {
+                    this->nextBoost = ((long)until + this->boostPeriod - 1) / this->boostPeriod * this->boostPeriod;
                 }
 
-                // Otherwise, if it's its first time running, calculate the response time
-                if (processInfo[pid].responseTime <= 0) {
-                    processInfo[pid].responseTime += this->_currentTime;
-                    // std::cout << pid << " resposta: " << processInfo[pid].responseTime << " chegada: " << processInfo[pid].arrivalTime << std::endl;
+                break;
+            }
+
+            // Highest priority level with processes in it
+            int currentQueue = __builtin_ctzll(this->nonEmptyLevels);
+            // Aging doesn't take the CPU from a process it's switching to before it gets to run, or switches could go on forever
+            if (this->switchingTo == -1) {
+                this->queues[currentQueue].schedule(this->processes, this->_currentTime);
+            }
+
+            // Only run execution logic after the initial second or on the second after a process arrives
+            if (this->_currentTime < 1 || this->processes.arrivalTime[queues[currentQueue].getCurrentProcess()] == this->_currentTime) {
+                if (this->_currentTime >= 1) {
+                    this->idleTime += 1;
                 }
-            } else {
-                // If it isn't running and didn't finish, that means it's waiting
-                processInfo[pid].waitingTime += 1;
-                // std::cout << pid << " wait: " << processInfo[pid].waitingTime << std::endl;
+
+                this->_currentTime += 1;
+
+                continue;
             }
+
+            // Stop at the next boost too
+            long limit = this->boostPeriod > 0 ? std::min((long)until, this->nextBoost) : until;
+
+            int currentProcess = queues[currentQueue].getCurrentProcess();
+            int pid = this->processes.pid[currentProcess];
+
+            // Switching to another process takes the CPU's time before the process gets to run
+            if (pid != this->switchingTo) {
+                this->switchingTo = pid;
+                this->switchLeft = this->lastPid != -1 && pid != this->lastPid ? this->switchCost.penalty(this->processes, currentProcess) : 0;
+            }
+            if (this->switchLeft > 0) {
+                int ticks = std::min((long)this->switchLeft, limit - this->_currentTime);
+
+                this->switchLeft -= ticks;
+                this->_statistics.switching(ticks);
+                this->_currentTime += ticks;
+
+                continue;
+            }
+
+            RunOutcome outcome;
+            int ticks = queues[currentQueue].run(limit - this->_currentTime, this->processes, outcome, this->_currentTime);
+
+            // Send processes that used up their quantum to the back of their (or the next) level
+            if (outcome == RunOutcome::Expired) {
+                int level = this->feedback ? std::min(currentQueue + 1, (int)this->queues.size() - 1) : currentQueue;
+
+                this->queues[level].add(currentProcess, this->processes, this->_currentTime + ticks);
+                this->updateLevel(level);
+            }
+            this->updateLevel(currentQueue);
+
+            this->account(currentProcess, ticks, outcome == RunOutcome::Finished);
+            this->_statistics.ran(pid, this->lastPid, ticks);
+            this->lastPid = pid;
+            this->switchingTo = -1;
+#ifdef SCHEDULER_TRACING
+            if (this->events != nullptr) {
+                this->tracker.ran(this->events, this->_currentTime, 0, pid, ticks, outcome == RunOutcome::Finished);
+            }
+#endif
+
+            this->_currentTime += ticks;
         }
+    }
+
+    void tick() {
+        this->advance(this->_currentTime + 1);
+    }
 
-        this->_currentTime += 1;
+#ifdef SCHEDULER_TRACING
+    // Records every event from now on to the given ring, if it's not null
+    void traceTo(EventRing* events) {
+        this->events = events;
     }
+#endif
 };
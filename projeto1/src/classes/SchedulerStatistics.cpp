@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+#include "../../../comum/Histogram.cpp"
+
+struct AverageTimes {
+    double responseTime;
+    double turnaroundTime;
+    double waitingTime;
+};
+
+struct TotalTimes {
+    long responseTime;
+    long turnaroundTime;
+    long waitingTime;
+};
+
+// Everything a scheduler measures about the processes it ran, kept online in constant memory so it works on traces of any length
+class SchedulerStatistics {
+private:
+    long _busyTime = 0;
+    long _contextSwitches = 0;
+    int _finishedN = 0;
+    // When the last process to finish did
+    int _makespan = 0;
+    // Times a CPU ran a process until something called for scheduling again
+    long _runs = 0;
+    // Units CPUs lost switching between processes
+    long _switchTime = 0;
+    TotalTimes totals = { 0, 0, 0 };
+    Histogram responseTimes;
+    Histogram turnaroundTimes;
+    Histogram waitingTimes;
+
+    static void printPercentiles(std::ostream& output, const char* name, const Histogram& histogram) {
+        output << "  " << name << " " << histogram.percentile(50) << " " << histogram.percentile(95) << " " << histogram.percentile(99) << " " << histogram.max() << std::endl;
+    }
+
+public:
+    // A process finished in the unit that ends at `end`
+    void finished(const int& responseTime, const int& turnaroundTime, const int& waitingTime, const int& end) {
+        this->totals.responseTime += responseTime;
+        this->totals.turnaroundTime += turnaroundTime;
+        this->totals.waitingTime += waitingTime;
+        this->responseTimes.add(responseTime);
+        this->turnaroundTimes.add(turnaroundTime);
+        // Processes dispatched on an idle CPU the unit they arrive have that unit taken from their waiting time twice, which the averages keep as -1, but they didn't wait at all
+        this->waitingTimes.add(std::max(waitingTime, 0));
+        this->_finishedN += 1;
+        this->_makespan = std::max(this->_makespan, end);
+    }
+
+    // A CPU ran a process for `ticks` units, after running `lastPid` (-1 for none)
+    void ran(const int& pid, const int& lastPid, const int& ticks) {
+        this->_busyTime += ticks;
+        this->_runs += 1;
+
+        if (lastPid != -1 && pid != lastPid) {
+            this->_contextSwitches += 1;
+        }
+    }
+
+    // A CPU spent `ticks` units switching to another process instead of running any
+    void switching(const int& ticks) {
+        this->_switchTime += ticks;
+    }
+
+    AverageTimes averageTimes() const {
+        AverageTimes averages = { 0, 0, 0 };
+        int processesN = this->_finishedN;
+
+        if (processesN > 0) {
+            averages.responseTime = (double)this->totals.responseTime / processesN;
+            averages.turnaroundTime = (double)this->totals.turnaroundTime / processesN;
+            averages.waitingTime = (double)this->totals.waitingTime / processesN;
+        }
+
+        return averages;
+    }
+
+    long busyTime() const {
+        return this->_busyTime;
+    }
+
+    long contextSwitches() const {
+        return this->_contextSwitches;
+    }
+
+    int finishedN() const {
+        return this->_finishedN;
+    }
+
+    int makespan() const {
+        return this->_makespan;
+    }
+
+    long runs() const {
+        return this->_runs;
+    }
+
+    const Histogram& response() const {
+        return this->responseTimes;
+    }
+
+    // Processes finished per unit, until the last one did
+    double throughput() const {
+        return this->_makespan > 0 ? (double)this->_finishedN / this->_makespan : 0;
+    }
+
+    long switchTime() const {
+        return this->_switchTime;
+    }
+
+    const Histogram& turnaround() const {
+        return this->turnaroundTimes;
+    }
+
+    // Share of the time until the last process finished that the CPUs, together, spent running processes
+    double utilization(const int& cpusN = 1) const {
+        return this->_makespan > 0 ? (double)this->_busyTime / ((long)cpusN * this->_makespan) : 0;
+    }
+
+    const Histogram& waiting() const {
+        return this->waitingTimes;
+    }
+
+    // Median, 95th and 99th percentiles and maximum of turnaround, response and waiting times, then utilization, throughput, context switches and the time lost to them, each on its own line
+    void print(std::ostream& output, const int& cpusN = 1) const {
+        printPercentiles(output, "retorno", this->turnaroundTimes);
+        printPercentiles(output, "resposta", this->responseTimes);
+        printPercentiles(output, "espera", this->waitingTimes);
+
+        output << "  utilização " << std::fixed << std::setprecision(4) << this->utilization(cpusN) << std::endl;
+        output << "  vazão " << this->throughput() << std::defaultfloat << std::endl;
+        this->printSwitches(output);
+    }
+
+    // Context switches and the time lost to them, each on its own line
+    void printSwitches(std::ostream& output) const {
+        output << "  trocas de contexto " << this->_contextSwitches << std::endl;
+        output << "  tempo perdido em trocas " << this->_switchTime << std::endl;
+    }
+};
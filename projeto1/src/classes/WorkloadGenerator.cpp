@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "../../../comum/Random.cpp"
+
+struct WorkloadConfig {
+    long processesN;
+    // Processes arriving per time unit, on average
+    double arrivalRate;
+    // Of the processes' durations, rounded up
+    std::string burst;
+    // Priorities are drawn uniformly from 0 to prioritiesN - 1
+    int prioritiesN;
+    std::uint64_t seed;
+};
+
+// Generates a synthetic process trace, one process at a time and in arrival order, so it can be streamed to disk. Arrivals are a Poisson process and the same seed always gives the same trace
+class WorkloadGenerator {
+private:
+    WorkloadConfig config;
+    Distribution burst;
+    Random random;
+    // Arrivals are kept exact and only truncated when handed out
+    double arrivalTime = 0;
+    long generatedN = 0;
+
+public:
+    explicit WorkloadGenerator(const WorkloadConfig& config) : config(config), burst(config.burst), random(config.seed) {
+        if (config.arrivalRate <= 0) {
+            throw std::invalid_argument("Arrival rate must be positive.");
+        }
+
+        if (config.prioritiesN < 1) {
+            throw std::invalid_argument("There must be at least one priority.");
+        }
+    }
+
+    // Gets the next process. Returns false once every one was generated
+    bool next(int& arrivalTime, int& duration, int& priority) {
+        if (this->generatedN >= this->config.processesN) {
+            return false;
+        }
+
+        // Time between Poisson arrivals is exponential
+        this->arrivalTime += this->random.exponential(1 / this->config.arrivalRate);
+        if (this->arrivalTime > INT_MAX) {
+            throw std::invalid_argument("Generated arrival times don't fit in the trace anymore.");
+        }
+
+        arrivalTime = this->arrivalTime;
+        // Heavy tails are cut where durations stop fitting
+        duration = std::max(1.0, std::min(std::ceil(this->burst.sample(this->random)), (double)INT_MAX));
+        priority = this->random.uniformInt(this->config.prioritiesN);
+        this->generatedN += 1;
+
+        return true;
+    }
+};
@@ -1,26 +1,143 @@
+#include <algorithm>
+#include <cctype>
 #include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <vector>
 
+#include "./classes/Arrivals.cpp"
+#include "./classes/MultiprocessorScheduler.cpp"
 #include "./classes/Scheduler.cpp"
-#include "./utils/split.cpp"
-
-// {
-//     [Arrival time]: duration[]
-// }
-std::vector<std::vector<Process>> processes;
+#include "./classes/WorkloadGenerator.cpp"
+#include "../../comum/parallelFor.cpp"
+#include "../../comum/parseRange.cpp"
+#include "./utils/simulate.cpp"
+#include "../../comum/split.cpp"
 
 struct SchedulerParams {
     std::vector<std::string> algorithms;
     std::vector<int> params;
 };
 
-struct Schedulers {
-    Scheduler fcfs;
-    Scheduler sjf;
-    Scheduler rr;
+struct NamedPolicy {
+    std::string name;
+    SchedulerParams levels;
+    // Only for multilevel schedulers
+    bool feedback;
+    int boostPeriod;
+};
+
+// Load balancer of a multiprocessor scheduler and, for periodic balancing, its period
+struct BalancerParams {
+    std::string balancer;
+    int period;
 };
 
+// Parses levels such as "rr:2,aging:10,fcfs" (algorithm and, for round-robin or aging, its quantum or aging period)
+SchedulerParams parseLevels(const std::string& levels) {
+    SchedulerParams params;
+
+    for (const std::string& level : split(levels, ",")) {
+        std::vector<std::string> info = split(level, ":");
+
+        params.algorithms.push_back(info[0]);
+        if (info.size() > 1) {
+            params.params.push_back(std::stoi(info[1]));
+        }
+    }
+
+    return params;
+}
+
+// Parses a load balancer such as "periodic:10"
+BalancerParams parseBalancer(const std::string& balancer) {
+    std::vector<std::string> info = split(balancer, ":");
+
+    return { info[0], info.size() > 1 ? std::stoi(info[1]) : 0 };
+}
+
+Trace readTrace(const std::string& path) {
+    Trace processes;
+
+    TraceReader reader(path, PROCESS_TRACE);
+    int info[4], infoN;
+    // Pids are handed out in input order
+    int processesN = 0;
+
+    while ((infoN = reader.readLine(info, 4)) > 0) {
+        if (infoN < 2) {
+            throw std::invalid_argument("Every process needs an arrival time and a duration.");
+        }
+
+        int arrivalTime = info[0];
+        int duration = info[1];
+        // Only used by multilevel and priority schedulers
+        int priority = infoN > 2 ? info[2] : 0;
+        // Only used by multiprocessor schedulers
+        int cpu = infoN > 3 ? info[3] : -1;
+
+        processes[arrivalTime].push_back(Process(processesN, duration, priority, cpu));
+        processesN += 1;
+    }
+
+    return processes;
+}
+
+// Writes a text trace's processes, in the same order, to a binary trace
+void convertTrace(const std::string& path, const std::string& output) {
+    TraceReader reader(path, PROCESS_TRACE);
+    BinaryTraceWriter writer(output, PROCESS_TRACE);
+    int info[4], infoN;
+
+    while ((infoN = reader.readLine(info, 4)) > 0) {
+        if (infoN < 2) {
+            throw std::invalid_argument("Every process needs an arrival time and a duration.");
+        }
+
+        writer.writeProcess(info[0], info[1], infoN > 2 ? info[2] : 0, infoN > 3 ? info[3] : -1);
+    }
+}
+
+// Where the events of a policy running a file go: the given path with the policy's name (and the file's index, if there are several) before its extension
+std::string eventTracePath(const std::string& path, const std::string& policy, const int& file, const int& filesN) {
+    std::size_t dot = path.rfind('.');
+    if (dot == std::string::npos || dot < path.rfind('/') + 1) {
+        dot = path.size();
+    }
+
+    return path.substr(0, dot) + (filesN > 1 ? "-" + std::to_string(file) : "") + "-" + policy + path.substr(dot);
+}
+
+// Writes a synthetic trace straight to disk, as text or as a binary trace
+void generateTrace(const WorkloadConfig& config, const std::string& output, const bool& binary) {
+    WorkloadGenerator generator(config);
+    int arrivalTime, duration, priority;
+
+    if (binary) {
+        BinaryTraceWriter writer(output, PROCESS_TRACE);
+
+        while (generator.next(arrivalTime, duration, priority)) {
+            writer.writeProcess(arrivalTime, duration, priority);
+        }
+
+        return;
+    }
+
+    std::ofstream file(output);
+    if (!file) {
+        throw std::invalid_argument("Couldn't open " + output + " for writing.");
+    }
+
+    while (generator.next(arrivalTime, duration, priority)) {
+        file << arrivalTime << " " << duration << " " << priority << "\n";
+    }
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 2) {
         std::cout << "Por favor, informe o caminho do arquivo de entrada." << std::endl;
@@ -28,64 +145,291 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    // Jump between scheduling events instead of simulating every time unit
+    bool eventDriven = false;
+    // Read each file as it's simulated instead of loading it first, sorting this many processes ahead
+    bool streamed = false;
+    int lookahead = 4096;
+    std::vector<std::string> paths;
+    // Extra multilevel scheduler, if any levels were given
+    SchedulerParams levels;
+    bool feedback = false;
+    int boostPeriod = 0;
+    int threadsN = std::thread::hardware_concurrency();
+    // Simulated CPUs, each with its own run queue when there's more than one
+    int cpusN = 1;
+    BalancerParams balancer = { "stealing", 0 };
+    int quantum = 2;
+    // Units a process waits to go up a priority under aging
+    int agingPeriod = 10;
+    // Single-level policies to run, each on its own
+    std::vector<std::string> policyNames = { "fcfs", "sjf", "rr" };
+    // RR quantums to evaluate instead of running every policy once
+    std::vector<int> quantums;
+    // Binary trace to convert the input file to, instead of simulating it
+    std::string convertTo;
+    // Synthetic trace to generate, instead of simulating anything
+    std::string generateTo;
+    WorkloadConfig workload = { 1000, 0.09, "exp:10", 1, 1 };
+    bool binary = false;
+    // Where every policy's events go, as a Chrome trace (.json) or CSV
+    std::string eventsPath;
+    // Print percentiles, utilization, throughput and context switches along with the averages
+    bool detailed = false;
+    // Units every context switch costs the CPU, plus cache warm-up for processes that already ran
+    SwitchCost switchCost = { 0, 0 };
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--events") {
+            eventDriven = true;
+        } else if (arg == "--stream") {
+            streamed = true;
+        } else if (arg == "--lookahead" && i + 1 < argc) {
+            lookahead = std::stoi(argv[++i]);
+        } else if (arg == "--levels" && i + 1 < argc) {
+            levels = parseLevels(argv[++i]);
+        } else if (arg == "--feedback") {
+            feedback = true;
+        } else if (arg == "--boost" && i + 1 < argc) {
+            boostPeriod = std::stoi(argv[++i]);
+        } else if (arg == "--quantum" && i + 1 < argc) {
+            quantum = std::stoi(argv[++i]);
+        } else if (arg == "--aging" && i + 1 < argc) {
+            agingPeriod = std::stoi(argv[++i]);
+        } else if (arg == "--policies" && i + 1 < argc) {
+            policyNames = split(argv[++i], ",");
+        } else if (arg == "--sweep-quantum" && i + 1 < argc) {
+            quantums = parseRange(argv[++i]);
+        } else if (arg == "--cpus" && i + 1 < argc) {
+            cpusN = std::stoi(argv[++i]);
+        } else if (arg == "--balance" && i + 1 < argc) {
+            balancer = parseBalancer(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threadsN = std::stoi(argv[++i]);
+        } else if (arg == "--convert" && i + 1 < argc) {
+            convertTo = argv[++i];
+        } else if (arg == "--generate" && i + 1 < argc) {
+            generateTo = argv[++i];
+        } else if (arg == "--count" && i + 1 < argc) {
+            workload.processesN = std::stol(argv[++i]);
+        } else if (arg == "--arrival-rate" && i + 1 < argc) {
+            workload.arrivalRate = std::stod(argv[++i]);
+        } else if (arg == "--burst" && i + 1 < argc) {
+            workload.burst = argv[++i];
+        } else if (arg == "--priorities" && i + 1 < argc) {
+            workload.prioritiesN = std::stoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            workload.seed = std::stoull(argv[++i]);
+        } else if (arg == "--binary") {
+            binary = true;
+        } else if (arg == "--percentiles") {
+            detailed = true;
+        } else if (arg == "--switch-cost" && i + 1 < argc) {
+            switchCost.dispatch = std::stoi(argv[++i]);
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            switchCost.warmup = std::stoi(argv[++i]);
+        } else if (arg == "--trace-events" && i + 1 < argc) {
+#ifdef SCHEDULER_TRACING
+            eventsPath = argv[++i];
+#else
+            std::cout << "Compile com -DSCHEDULER_TRACING para registrar eventos." << std::endl;
+
+            return 1;
+#endif
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cout << "Opção desconhecida: " << arg << std::endl;
+
+            return 1;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    if (!generateTo.empty()) {
+        generateTrace(workload, generateTo, binary);
+
+        return 0;
+    }
+
+    if (paths.empty()) {
+        std::cout << "Por favor, informe o caminho do arquivo de entrada." << std::endl;
+
+        return 1;
+    }
+
+    if (!convertTo.empty()) {
+        convertTrace(paths.front(), convertTo);
+
+        return 0;
+    }
+
+    if (lookahead < 1) {
+        std::cout << "O --lookahead deve ser positivo." << std::endl;
+
+        return 1;
+    }
+
+    if (cpusN > 1 && !levels.algorithms.empty()) {
+        std::cout << "Escalonadores multinível só rodam em um processador." << std::endl;
+
+        return 1;
+    }
+
     // Queue fcfsQueue = Queue("fcfs"), sjfQueue = Queue("sjf"), rrQueue = Queue("rr", 2);
-    Schedulers schedulers;
-    schedulers.fcfs = Scheduler({ "fcfs" });
-    schedulers.sjf = Scheduler({ "sjf" });
-    schedulers.rr = Scheduler({ "rr" }, { 2 });
+    std::vector<NamedPolicy> policies;
+    for (const std::string& policy : policyNames) {
+        std::string name = policy;
+        std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+
+        if (policy == "rr") {
+            policies.push_back({ name, { { policy }, { quantum } }, false, 0 });
+        } else if (policy == "aging") {
+            policies.push_back({ name, { { policy }, { agingPeriod } }, false, 0 });
+        } else {
+            policies.push_back({ name, { { policy }, {} }, false, 0 });
+        }
+    }
 
-    std::ifstream input(argv[1]);
-    std::string line;
+    if (!levels.algorithms.empty()) {
+        policies.push_back({ feedback ? "MLFQ" : "MLQ", levels, feedback, boostPeriod });
+    }
 
-    while (std::getline(input, line)) {
-        std::vector<string> info = split(line, " ");
+    int filesN = paths.size(), policiesN = policies.size();
 
-        int arrivalTime = stoi(info[0]);
-        int duration = stoi(info[1]);
+    // Runs every job in parallel, printing why the first one that failed did (such as an invalid or, when streamed, too unsorted trace) instead of aborting
+    auto runJobs = [&](const int& jobsN, const std::function<void(int)>& job) {
+        try {
+            parallelFor(jobsN, job, threadsN);
+        } catch (const std::invalid_argument& error) {
+            std::cout << error.what() << std::endl;
 
-        if ((int)processes.size() < arrivalTime + 1) {
-            processes.resize(arrivalTime + 1);
+            return false;
         }
 
-        processes[arrivalTime].push_back(Process(duration));
+        return true;
+    };
+
+    std::vector<Trace> traces(streamed ? 0 : filesN);
+    if (!streamed) {
+        bool ran = runJobs(filesN, [&](int file) {
+            traces[file] = readTrace(paths[file]);
+        });
+        if (!ran) {
+            return 1;
+        }
     }
 
-    int currentTime = 0;
-    // While the schedulers haven't finished running or new processes will run in the future
-    while (
-        !schedulers.fcfs.finished() ||
-        !schedulers.sjf.finished() ||
-        !schedulers.rr.finished() ||
-        currentTime < (int)processes.size()
-        ) {
-        // std::cout << currentTime << std::endl;
+    // Runs a file through the given (single or multiprocessor) scheduler, from wherever it is
+    auto run = [&](auto& scheduler, const int& file, [[maybe_unused]] const std::string& policy) {
+        scheduler.setSwitchCost(switchCost);
+
+#ifdef SCHEDULER_TRACING
+        std::unique_ptr<EventTraceWriter> writer;
+        if (!eventsPath.empty()) {
+            writer = std::make_unique<EventTraceWriter>(eventTracePath(eventsPath, policy, file, filesN));
+            scheduler.traceTo(writer->events());
+        }
+#endif
+
+        if (streamed) {
+            StreamedArrivals arrivals(paths[file], lookahead);
+            simulate(scheduler, arrivals, eventDriven);
+        } else {
+            TraceArrivals arrivals(traces[file]);
+            simulate(scheduler, arrivals, eventDriven);
+        }
+
+#ifdef SCHEDULER_TRACING
+        if (writer) {
+            writer->stop();
+        }
+#endif
+    };
+
+    if (!quantums.empty()) {
+        int quantumsN = quantums.size();
+
+        // Every quantum of every file runs on its own, reusing the parsed trace
+        std::vector<std::string> rows(filesN * quantumsN);
+        bool ran = runJobs(filesN * quantumsN, [&](int job) {
+            SchedulerStatistics statistics;
 
-        // If there are still processes waiting to get queued, and there are some scheduled to arrive at this moment
-        if ((int)processes.size() > currentTime && processes[currentTime].size() > 0) {
-            // Get every process that arrived at the current time
-            for (Process process : processes[currentTime]) {
-                // And add it to the schedulers
-                schedulers.fcfs.insert(process, 0);
-                schedulers.sjf.insert(process, 0);
-                schedulers.rr.insert(process, 0);
+            if (cpusN > 1) {
+                MultiprocessorScheduler scheduler(cpusN, "rr", { quantums[job % quantumsN] }, balancer.balancer, balancer.period);
+                run(scheduler, job / quantumsN, "RR" + std::to_string(quantums[job % quantumsN]));
+                statistics = scheduler.statistics();
+            } else {
+                Scheduler scheduler({ "rr" }, { quantums[job % quantumsN] });
+                run(scheduler, job / quantumsN, "RR" + std::to_string(quantums[job % quantumsN]));
+                statistics = scheduler.statistics();
+            }
+
+            AverageTimes averages = statistics.averageTimes();
+            std::ostringstream row;
+            row << std::fixed << std::setprecision(3) << paths[job / quantumsN] << "," << quantums[job % quantumsN] << "," << averages.turnaroundTime << "," << averages.responseTime << "," << averages.waitingTime;
 
-                // std::cout << process.getPid() << " chegada: " << currentTime << std::endl;
+            // Tails of every time, then utilization, throughput, context switches and the time lost to them
+            if (detailed) {
+                for (const Histogram* times : { &statistics.turnaround(), &statistics.response(), &statistics.waiting() }) {
+                    row << "," << times->percentile(95) << "," << times->percentile(99);
+                }
+                row << "," << std::setprecision(4) << statistics.utilization(cpusN) << "," << statistics.throughput() << "," << statistics.contextSwitches() << "," << statistics.switchTime();
             }
+            row << std::endl;
+            rows[job] = row.str();
+        });
+        if (!ran) {
+            return 1;
+        }
+
+        std::cout << "arquivo,quantum,retorno,resposta,espera";
+        if (detailed) {
+            std::cout << ",retorno_p95,retorno_p99,resposta_p95,resposta_p99,espera_p95,espera_p99,utilizacao,vazao,trocas_de_contexto,tempo_perdido";
+        }
+        std::cout << std::endl;
+        for (const std::string& row : rows) {
+            std::cout << row;
         }
 
-        schedulers.fcfs.tick();
-        schedulers.sjf.tick();
-        schedulers.rr.tick();
+        return 0;
+    }
+
+    // Every policy of every file runs on its own, sharing the (read-only) trace and writing to its own output
+    std::vector<std::string> outputs(filesN * policiesN);
+    bool ran = runJobs(filesN * policiesN, [&](int job) {
+        const NamedPolicy& policy = policies[job % policiesN];
+        std::ostringstream output;
+
+        output << policy.name << " ";
+
+        if (cpusN > 1) {
+            MultiprocessorScheduler scheduler(cpusN, policy.levels.algorithms.front(), policy.levels.params, balancer.balancer, balancer.period);
+            run(scheduler, job / policiesN, policy.name);
+            scheduler.printStatistics(output, detailed);
+        } else {
+            Scheduler scheduler(policy.levels.algorithms, policy.levels.params, policy.feedback, policy.boostPeriod);
+            run(scheduler, job / policiesN, policy.name);
+            scheduler.printStatistics(output, detailed);
+        }
 
-        currentTime += 1;
+        outputs[job] = output.str();
+    });
+    if (!ran) {
+        return 1;
     }
 
-    std::cout << "FCFS ";
-    schedulers.fcfs.printStatistics();
-    std::cout << "SJF ";
-    schedulers.sjf.printStatistics();
-    std::cout << "RR ";
-    schedulers.rr.printStatistics();
+    // Which are then printed in order, no matter which one finished first
+    for (int file = 0; file < filesN; file++) {
+        if (filesN > 1) {
+            std::cout << paths[file] << std::endl;
+        }
+
+        for (int policy = 0; policy < policiesN; policy++) {
+            std::cout << outputs[file * policiesN + policy];
+        }
+    }
 
     return 0;
 }
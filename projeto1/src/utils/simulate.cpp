@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "../classes/Process.cpp"
+
+// Processes go to their priority's level, or the lowest one the scheduler has
+template <typename SchedulerType>
+void insert(SchedulerType& scheduler, const Process& process) {
+    scheduler.insert(process, std::min(process.priority(), scheduler.levels() - 1));
+}
+
+// Runs every batch of arrivals (from either TraceArrivals or StreamedArrivals) through a single (or multiprocessor) scheduler
+template <typename SchedulerType, typename Arrivals>
+void simulate(SchedulerType& scheduler, Arrivals& arrivals, const bool& eventDriven) {
+    int arrivalTime;
+    const std::vector<Process>* batch = arrivals.next(arrivalTime);
+
+    if (eventDriven) {
+        while (batch != nullptr) {
+            // Run the scheduler up to the moment the next batch arrives
+            scheduler.advance(arrivalTime);
+
+            for (const Process& process : *batch) {
+                insert(scheduler, process);
+            }
+
+            batch = arrivals.next(arrivalTime);
+        }
+
+        // And then until it's done
+        scheduler.advance(std::numeric_limits<int>::max());
+
+        return;
+    }
+
+    int currentTime = 0;
+    // While the scheduler hasn't finished running or new processes will run in the future
+    while (!scheduler.finished() || batch != nullptr) {
+        // std::cout << currentTime << std::endl;
+
+        // If there are some processes scheduled to arrive at this moment
+        if (batch != nullptr && arrivalTime == currentTime) {
+            // Add every one of them to the scheduler
+            for (const Process& process : *batch) {
+                insert(scheduler, process);
+
+                // std::cout << process.uuid() << " chegada: " << currentTime << std::endl;
+            }
+
+            batch = arrivals.next(arrivalTime);
+        }
+
+        scheduler.tick();
+
+        currentTime += 1;
+    }
+}
@@ -1,11 +1,11 @@
+#pragma once
+
 #include <random>
 #include <sstream>
 
-std::string uuid_v4() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, 15);
-    static std::uniform_int_distribution<> dis2(8, 11);
+std::string uuid_v4(std::mt19937& gen) {
+    std::uniform_int_distribution<> dis(0, 15);
+    std::uniform_int_distribution<> dis2(8, 11);
 
     std::stringstream ss;
     int i;
@@ -32,3 +32,17 @@ std::string uuid_v4() {
     };
     return ss.str();
 }
+
+std::string uuid_v4() {
+    static std::random_device rd;
+    static std::mt19937 gen(rd());
+
+    return uuid_v4(gen);
+}
+
+// Same seed, same UUID
+std::string uuid_v4(const unsigned& seed) {
+    std::mt19937 gen(seed);
+
+    return uuid_v4(gen);
+}
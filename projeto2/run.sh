@@ -1 +1 @@
-g++ -static "/home/hyoretsu/@Projects/@ufpb/so1/projeto2/src/"main.cpp -o /home/hyoretsu/@Projects/@ufpb/so1/projeto2/build/main.exe && ./build/main.exe $1
+cd "$(dirname "$0")" && mkdir -p build && g++ -O2 -static src/main.cpp -o build/main.exe && ./build/main.exe "$@"
@@ -0,0 +1,102 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "./classes/MemoryManagementUnit.cpp"
+#include "./classes/ReferenceGenerator.cpp"
+#include "./classes/References.cpp"
+#include "../../comum/measure.cpp"
+#include "../../comum/split.cpp"
+#include "./utils/simulate.cpp"
+
+// Times every policy's MMU over synthetic traces of every size and every number of frames, each case in its own process. Results can be saved and compared against ones saved before, e.g. from another commit
+int main(int argc, char* argv[]) {
+    std::vector<std::string> algorithms = supportedAlgorithms;
+    std::vector<long> sizes = { 1000, 10000, 100000, 1000000, 10000000 };
+    std::vector<long> framesNs = { 4, 64, 1024, 16384, 100000 };
+    int repetitions = 3;
+    // Zipf's exponent over four times as many pages as there are frames, unless a locality's given
+    ReferenceConfig generated = { 0, 0, "", 0.3, 1, 100, 1 };
+    std::string output, baselinePath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--policies" && i + 1 < argc) {
+            algorithms = split(argv[++i], ",");
+        } else if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            for (const std::string& size : split(argv[++i], ",")) {
+                sizes.push_back(std::stol(size));
+            }
+        } else if (arg == "--frames" && i + 1 < argc) {
+            framesNs.clear();
+            for (const std::string& framesN : split(argv[++i], ",")) {
+                framesNs.push_back(std::stol(framesN));
+            }
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            repetitions = std::stoi(argv[++i]);
+        } else if (arg == "--locality" && i + 1 < argc) {
+            generated.locality = argv[++i];
+        } else if (arg == "--processes" && i + 1 < argc) {
+            generated.processesN = std::stoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            generated.seed = std::stoull(argv[++i]);
+        } else if (arg == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "--compare" && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else {
+            std::cout << "Opção desconhecida: " << arg << std::endl;
+
+            return 1;
+        }
+    }
+
+    std::vector<BenchmarkResult> baseline, results;
+    if (!baselinePath.empty()) {
+        baseline = loadResults(baselinePath);
+    }
+
+    printHeader("referência");
+    for (const std::string& algorithm : algorithms) {
+        for (const long& framesN : framesNs) {
+            for (const long& size : sizes) {
+                BenchmarkResult result = measure(algorithm, size, framesN, [&]() {
+                    ReferenceConfig config = generated;
+                    config.referencesN = size;
+                    config.framesN = framesN;
+                    if (config.locality.empty()) {
+                        config.locality = "zipf:1:" + std::to_string(4 * framesN);
+                    }
+
+                    // The trace is generated up front, so only the MMU is timed. Its peak RSS does include the generation, which keeps the trace's growth and the generator's tables in the case's own process
+                    Trace trace = { (int)framesN, {}, {}, {}, {} };
+                    ReferenceGenerator generator(config);
+                    int pageNumber, pid;
+                    bool write;
+                    while (generator.next(pageNumber, write, pid)) {
+                        trace.add(pageNumber, write, pid);
+                    }
+                    trace.nextUses = findNextUses(trace.queue, trace.pids);
+
+                    return timeBest(repetitions, size, [&]() {
+                        MemoryManagementUnit mmu(framesN, algorithm);
+                        TraceReferences references(trace);
+
+                        simulate(mmu, references);
+                    });
+                });
+
+                printResult(result, baseline);
+                results.push_back(result);
+            }
+        }
+    }
+
+    if (!output.empty()) {
+        saveResults(output, results);
+    }
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "./ReplacementPolicy.cpp"
+
+// Adaptive Replacement Cache (Megiddo and Modha). Balances a list of pages seen once recently (T1) against one of pages seen at least twice (T2), moving the target size of T1 according to hits in the ghost lists of pages recently evicted from each (B1 and B2)
+class ArcPolicy : public ReplacementPolicy {
+private:
+    int framesN;
+    // Target size of T1
+    int target = 0;
+    // Resident lists, from the least to the most recently used
+    FrameList recent;
+    FrameList frequent;
+    std::vector<bool> inFrequent;
+    // Ghost lists' page keys, from the least to the most recently used
+    std::list<long> recentGhosts;
+    std::list<long> frequentGhosts;
+    // Where each ghost is, and whether it's in B2
+    typedef std::unordered_map<long, std::pair<bool, std::list<long>::iterator>> GhostMap;
+    GhostMap ghosts;
+    // Keys of resident pages, to remember evicted ones
+    std::vector<long> keys;
+    // Whether the page being loaded was found in a ghost list, so it goes to T2
+    bool loadFrequent = false;
+
+    void forget(std::list<long>& ghostList) {
+        this->ghosts.erase(ghostList.front());
+        ghostList.pop_front();
+    }
+
+    // Adapts the target to a miss on a page that was in a ghost list, and takes it out of there. Returns whether it was in B2
+    bool hitGhost(const GhostMap::iterator& found) {
+        int recentGhostsN = this->recentGhosts.size(), frequentGhostsN = this->frequentGhosts.size();
+        bool inFrequentGhosts = found->second.first;
+
+        if (!inFrequentGhosts) {
+            this->target = std::min(this->framesN, this->target + std::max(frequentGhostsN / recentGhostsN, 1));
+        } else {
+            this->target = std::max(0, this->target - std::max(recentGhostsN / frequentGhostsN, 1));
+        }
+
+        (inFrequentGhosts ? this->frequentGhosts : this->recentGhosts).erase(found->second.second);
+        this->ghosts.erase(found);
+
+        return inFrequentGhosts;
+    }
+
+    void remember(const bool& frequentGhost, const long& key) {
+        std::list<long>& ghostList = frequentGhost ? this->frequentGhosts : this->recentGhosts;
+
+        ghostList.push_back(key);
+        this->ghosts[key] = { frequentGhost, std::prev(ghostList.end()) };
+    }
+
+    // Evicts from T1 or T2 depending on the target, moving the page to its ghost list
+    int replace(const bool& inFrequentGhosts) {
+        int recentN = this->recent.size();
+        bool fromRecent = recentN >= 1 && ((inFrequentGhosts && recentN == this->target) || recentN > this->target);
+
+        // Which, when processes share the RAM, might be asked before its lists fill it
+        if (this->frequent.size() == 0) {
+            fromRecent = true;
+        }
+
+        FrameList& list = fromRecent ? this->recent : this->frequent;
+        int frame = list.front();
+        list.unlink(frame);
+
+        this->remember(!fromRecent, this->keys[frame]);
+
+        return frame;
+    }
+
+public:
+    // Constructors
+    explicit ArcPolicy(const int& framesN) : framesN(framesN), recent(framesN), frequent(framesN), inFrequent(framesN, false), keys(framesN, 0) {}
+
+    void loaded(const Page& page) override {
+        long key = pageKey(page.pid, page.index);
+
+        // Under local replacement pages also get frames that evict() didn't free, in which case their ghost is still there
+        auto found = this->ghosts.find(key);
+        if (found != this->ghosts.end()) {
+            this->hitGhost(found);
+            this->loadFrequent = true;
+        }
+
+        this->keys[page.frame] = key;
+        this->inFrequent[page.frame] = this->loadFrequent;
+        (this->loadFrequent ? this->frequent : this->recent).append(page.frame);
+
+        this->loadFrequent = false;
+
+        // Which also means the lists may have grown past their bounds, T1 and B1 holding up to a cache's worth of pages and all four up to two
+        while (this->recent.size() + (int)this->recentGhosts.size() > this->framesN && !this->recentGhosts.empty()) {
+            this->forget(this->recentGhosts);
+        }
+        while (this->recent.size() + this->frequent.size() + (int)(this->recentGhosts.size() + this->frequentGhosts.size()) > 2 * this->framesN && !this->frequentGhosts.empty()) {
+            this->forget(this->frequentGhosts);
+        }
+    }
+
+    void accessed(const Page& page) override {
+        (this->inFrequent[page.frame] ? this->frequent : this->recent).unlink(page.frame);
+
+        this->inFrequent[page.frame] = true;
+        this->frequent.append(page.frame);
+    }
+
+    // Only called once the cache is full, which is also the only time the ghost lists have anything in them
+    int evict(const long& key) override {
+        auto found = this->ghosts.find(key);
+
+        if (found != this->ghosts.end()) {
+            int frame = this->replace(this->hitGhost(found));
+            this->loadFrequent = true;
+
+            return frame;
+        }
+
+        int recentN = this->recent.size(), recentGhostsN = this->recentGhosts.size(), frequentGhostsN = this->frequentGhosts.size();
+
+        if (recentN + recentGhostsN == this->framesN) {
+            if (recentN < this->framesN) {
+                this->forget(this->recentGhosts);
+
+                return this->replace(false);
+            }
+
+            // T1 is the whole cache, so its oldest page is dropped without a ghost
+            int frame = this->recent.front();
+            this->recent.unlink(frame);
+
+            return frame;
+        }
+
+        if (recentN + this->frequent.size() + recentGhostsN + frequentGhostsN == 2 * this->framesN) {
+            this->forget(this->frequentGhosts);
+        }
+
+        return this->replace(false);
+    }
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include "./ReplacementPolicy.cpp"
+
+// Sweeps a hand around the frames, clearing reference bits until it finds a page that wasn't referenced since the last sweep. Frames whose pages it wasn't told about (another process') are skipped
+class ClockPolicy : public ReplacementPolicy {
+private:
+    int hand = 0;
+    std::vector<bool> referenced;
+    std::vector<bool> resident;
+
+public:
+    // Constructors
+    explicit ClockPolicy(const int& framesN) : referenced(framesN, false), resident(framesN, false) {}
+
+    void loaded(const Page& page) override {
+        // Set by the reference that loaded it
+        this->referenced[page.frame] = true;
+        this->resident[page.frame] = true;
+    }
+
+    void accessed(const Page& page) override {
+        this->referenced[page.frame] = true;
+    }
+
+    int evict(const long&) override {
+        int framesN = this->referenced.size();
+
+        while (!this->resident[this->hand] || this->referenced[this->hand]) {
+            this->referenced[this->hand] = false;
+            this->hand = (this->hand + 1) % framesN;
+        }
+
+        int frame = this->hand;
+        this->resident[frame] = false;
+        this->hand = (this->hand + 1) % framesN;
+
+        return frame;
+    }
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "./ReplacementPolicy.cpp"
+
+// Evicts the page that was loaded first
+class FifoPolicy : public ReplacementPolicy {
+private:
+    FrameList frames;
+
+public:
+    // Constructors
+    explicit FifoPolicy(const int& framesN) : frames(framesN) {}
+
+    void loaded(const Page& page) override {
+        this->frames.append(page.frame);
+    }
+
+    void accessed(const Page&) override {}
+
+    int evict(const long&) override {
+        int frame = this->frames.front();
+        this->frames.unlink(frame);
+
+        return frame;
+    }
+};
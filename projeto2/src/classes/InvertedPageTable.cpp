@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "./TranslationTable.cpp"
+
+// One entry per frame, shared by every process and found through a hash anchor table whose chains link frames with colliding pages. Its size depends on the RAM instead of the address spaces
+class InvertedPageTable : public TranslationTable {
+private:
+    static constexpr int EMPTY = -1;
+
+    struct Entry {
+        int pid;
+        PageNumber pageNumber;
+        // Next frame in the same chain
+        int next;
+    };
+
+    // First frame of each chain, a power of two at least as big as the RAM (and at least 2)
+    std::vector<int> anchors;
+    // Fibonacci hashing keeps the product's top bits, as many as index the anchors
+    int anchorShift = 63;
+    // Indexed by frame
+    std::vector<Entry> entries;
+    std::size_t _size = 0;
+
+    std::size_t home(const int& pid, const PageNumber& pageNumber) const {
+        return (pageNumber ^ (PageNumber)pid << 16) * 11400714819323198485u >> this->anchorShift;
+    }
+
+public:
+    // Constructors
+    explicit InvertedPageTable(const int& framesN) : entries(framesN, { 0, 0, EMPTY }) {
+        std::size_t anchorsN = 2;
+        while (anchorsN < (std::size_t)framesN) {
+            anchorsN *= 2;
+            this->anchorShift -= 1;
+        }
+
+        this->anchors.assign(anchorsN, EMPTY);
+    }
+
+    int get(const int& pid, const PageNumber& pageNumber) override {
+        this->walks += 1;
+        // Reading the anchor
+        this->walkSteps += 1;
+
+        for (int frame = this->anchors[this->home(pid, pageNumber)]; frame != EMPTY; frame = this->entries[frame].next) {
+            this->walkSteps += 1;
+
+            if (this->entries[frame].pageNumber == pageNumber && this->entries[frame].pid == pid) {
+                return frame;
+            }
+        }
+
+        return EMPTY;
+    }
+
+    void set(const int& pid, const PageNumber& pageNumber, const int& frame) override {
+        int& anchor = this->anchors[this->home(pid, pageNumber)];
+
+        this->entries[frame] = { pid, pageNumber, anchor };
+        anchor = frame;
+        this->_size += 1;
+    }
+
+    void remove(const int& pid, const PageNumber& pageNumber) override {
+        for (int* link = &this->anchors[this->home(pid, pageNumber)]; *link != EMPTY; link = &this->entries[*link].next) {
+            if (this->entries[*link].pageNumber == pageNumber && this->entries[*link].pid == pid) {
+                *link = this->entries[*link].next;
+                this->_size -= 1;
+
+                return;
+            }
+        }
+    }
+
+    std::size_t size() const override {
+        return this->_size;
+    }
+
+    long footprint() const override {
+        return (long)this->entries.size() * ENTRY_SIZE + (long)this->anchors.size() * (long)sizeof(int);
+    }
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "./ReplacementPolicy.cpp"
+
+// Evicts the least frequently used page, the least recently used among ties. Pages are kept in one list per use count, so that every operation is constant time
+// Evicts the least frequently used page, the least recently used among ties. Pages are kept in one list per use count and the lists are linked in count order, so that every operation is constant time
+class LfuPolicy : public ReplacementPolicy {
+private:
+    struct Bucket {
+        int first;
+        int last;
+        // Neighbouring counts that have pages, 0 for none
+        int lower;
+        int higher;
+    };
+
+    // Use count of the page in each frame
+    std::vector<int> counts;
+    // Lists of frames with the same count, from the least to the most recently used
+    std::unordered_map<int, Bucket> buckets;
+    std::vector<int> previous;
+    std::vector<int> next;
+    // Lowest count of a resident page, 0 for none
+    int minCount = 0;
+
+    // Puts the frame at the end of the list of its count, which goes between lower and higher if it's new
+    void append(const int& frame, int lower, int higher) {
+        int count = this->counts[frame];
+        auto found = this->buckets.find(count);
+
+        this->next[frame] = NO_FRAME;
+        if (found != this->buckets.end()) {
+            this->previous[frame] = found->second.last;
+            this->next[found->second.last] = frame;
+            found->second.last = frame;
+            return;
+        }
+
+        this->previous[frame] = NO_FRAME;
+        this->buckets[count] = { frame, frame, lower, higher };
+
+        if (lower != 0) {
+            this->buckets[lower].higher = count;
+        } else {
+            this->minCount = count;
+        }
+
+        if (higher != 0) {
+            this->buckets[higher].lower = count;
+        }
+    }
+
+    void unlink(const int& frame) {
+        Bucket& bucket = this->buckets[this->counts[frame]];
+
+        if (this->previous[frame] != NO_FRAME) {
+            this->next[this->previous[frame]] = this->next[frame];
+        } else {
+            bucket.first = this->next[frame];
+        }
+
+        if (this->next[frame] != NO_FRAME) {
+            this->previous[this->next[frame]] = this->previous[frame];
+        } else {
+            bucket.last = this->previous[frame];
+        }
+
+        if (bucket.first != NO_FRAME) {
+            return;
+        }
+
+        // The count has no pages left, so its neighbours become adjacent
+        if (bucket.lower != 0) {
+            this->buckets[bucket.lower].higher = bucket.higher;
+        } else {
+            this->minCount = bucket.higher;
+        }
+
+        if (bucket.higher != 0) {
+            this->buckets[bucket.higher].lower = bucket.lower;
+        }
+
+        this->buckets.erase(this->counts[frame]);
+    }
+
+public:
+    // Constructors
+    explicit LfuPolicy(const int& framesN) : counts(framesN, 0), previous(framesN, NO_FRAME), next(framesN, NO_FRAME) {}
+
+    void loaded(const Page& page) override {
+        this->counts[page.frame] = 1;
+        this->append(page.frame, 0, this->minCount);
+    }
+
+    void accessed(const Page& page) override {
+        int count = this->counts[page.frame];
+        const Bucket& bucket = this->buckets[count];
+        int lower = bucket.lower;
+        int higher = bucket.higher;
+
+        this->unlink(page.frame);
+
+        this->counts[page.frame] += 1;
+        this->append(page.frame, this->buckets.count(count) != 0 ? count : lower, higher);
+    }
+
+    int evict(const long&) override {
+        // The eviction may empty the lowest count, in which case unlinking moves it up to the next one, whether or not a page is loaded right after
+        if (this->minCount == 0) {
+            return NO_FRAME;
+        }
+
+        int frame = this->buckets[this->minCount].first;
+        this->unlink(frame);
+
+        return frame;
+    }
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "./ReplacementPolicy.cpp"
+
+// Evicts the least recently used page
+class LruPolicy : public ReplacementPolicy {
+private:
+    // From the least to the most recently used
+    FrameList frames;
+
+public:
+    // Constructors
+    explicit LruPolicy(const int& framesN) : frames(framesN) {}
+
+    void loaded(const Page& page) override {
+        this->frames.append(page.frame);
+    }
+
+    void accessed(const Page& page) override {
+        // Most recently used goes to the back
+        this->frames.unlink(page.frame);
+        this->frames.append(page.frame);
+    }
+
+    int evict(const long&) override {
+        int frame = this->frames.front();
+        this->frames.unlink(frame);
+
+        return frame;
+    }
+};
@@ -1,123 +1,229 @@
+#pragma once
+
 #include <algorithm>
-#include <limits>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "./ArcPolicy.cpp"
+#include "./ClockPolicy.cpp"
+#include "./FifoPolicy.cpp"
+#include "./InvertedPageTable.cpp"
+#include "./LfuPolicy.cpp"
+#include "./LruPolicy.cpp"
+#include "./MultiLevelPageTable.cpp"
+#include "./NruPolicy.cpp"
+#include "./OptimalPolicy.cpp"
+#include "./PageTable.cpp"
 #include "./RandomAccessMemory.cpp"
+#include "./References.cpp"
+#include "./ReplacementPolicy.cpp"
+#include "./SecondChancePolicy.cpp"
+#include "./TranslationLookasideBuffer.cpp"
+#include "./TranslationTable.cpp"
+#include "./WorkingSet.cpp"
+#include "../../../comum/Histogram.cpp"
+
+std::vector<std::string> supportedAlgorithms = { "fifo", "otm", "lru", "clock", "second-chance", "nru", "lfu", "arc" };
+const char* unsupportedAlgorithmMessage = "Only FIFO, Ótimo, Least Recently Used, Clock, Second-Chance, NRU, LFU and ARC MMU's are supported.";
+
+std::unique_ptr<ReplacementPolicy> makePolicy(const std::string& algorithm, const int& framesN) {
+    if (algorithm == "fifo") {
+        return std::make_unique<FifoPolicy>(framesN);
+    } else if (algorithm == "otm") {
+        return std::make_unique<OptimalPolicy>(framesN);
+    } else if (algorithm == "lru") {
+        return std::make_unique<LruPolicy>(framesN);
+    } else if (algorithm == "clock") {
+        return std::make_unique<ClockPolicy>(framesN);
+    } else if (algorithm == "second-chance") {
+        return std::make_unique<SecondChancePolicy>(framesN);
+    } else if (algorithm == "nru") {
+        return std::make_unique<NruPolicy>(framesN);
+    } else if (algorithm == "lfu") {
+        return std::make_unique<LfuPolicy>(framesN);
+    } else if (algorithm == "arc") {
+        return std::make_unique<ArcPolicy>(framesN);
+    }
+
+    throw std::invalid_argument(unsupportedAlgorithmMessage);
+}
+
+// Null for the (unmodelled) hash table
+std::unique_ptr<TranslationTable> makeTable(const TableConfig& config, const int& framesN) {
+    if (config.layout == "hash") {
+        return nullptr;
+    } else if (config.layout == "multilevel") {
+        return std::make_unique<MultiLevelPageTable>(config.levelsN, config.pageNumberBits);
+    } else if (config.layout == "inverted") {
+        return std::make_unique<InvertedPageTable>(framesN);
+    }
+
+    throw std::invalid_argument("Only hash, multilevel and inverted page tables are supported.");
+}
 
-std::vector<std::string> supportedAlgorithms = { "fifo", "otm", "lru" };
-const char* unsupportedAlgorithmMessage = "Only FIFO, Ótimo and Least Recently Used MMU's are supported.";
+// Time lost to each kind of event, in whatever unit the latencies are given
+struct CostModel {
+    long faultLatency;
+    long writeBackLatency;
+};
 
-struct Page {
-    int index;
-    int frame;
-    bool valid;
-    bool dirty;
-    int accessed;
+struct MmuOptions {
+    // TLB in front of the page tables, if it has any entries
+    TlbConfig tlb;
+    TableConfig table;
+    // Whether processes only replace their own pages (once they have their share of the frames) instead of anyone's
+    bool local;
+    // References each process' working set spans, 0 for none
+    int workingSetWindow;
+    // References in each window the page fault rate is measured over, 0 for none
+    int faultWindow;
 };
 
+// Translates the pages of any number of processes, each with its own page table, into the frames of a single RAM
 class MemoryManagementUnit {
 private:
     std::string algorithm;
-    int frameSize;
+    int framesN;
     int history;
+    // Bits of the virtual page numbers, past which references don't fit in the address space
+    int pageNumberBits;
+    bool local = false;
     int _pageFaults;
+    // Dirty pages written back to disk when evicted
+    int _writeBacks = 0;
+    // Each process' table, replaced by _table when laid out like hardware's
+    std::vector<PageTable> pageTables;
+    std::unique_ptr<TranslationTable> _table;
+    // Resident pages, indexed by their frame
     std::vector<Page> pages;
-    std::vector<int> queue;
+    int residentsN = 0;
+    // A single policy for global replacement, or one per process for local replacement
+    std::vector<std::unique_ptr<ReplacementPolicy>> policies;
     RandomAccessMemory ram;
+    // Translation cache in front of the page table, if any
+    std::unique_ptr<TranslationLookasideBuffer> _tlb;
+    // Per process, indexed by pid
+    std::vector<bool> seen;
+    std::vector<int> residents;
+    std::vector<int> processFaults;
+    std::vector<WorkingSet> workingSets;
+    int _processesN = 0;
+    int workingSetWindow = 0;
+    // Sum of every process' working set, now and over every reference so far
+    long workingSetsTotal = 0;
+    long workingSetsSum = 0;
+    // References after which the working sets didn't fit in the RAM
+    long thrashingN = 0;
+    int faultWindow = 0;
+    // Page faults when the current window started, and how many happened in each window before it
+    int windowStartFaults = 0;
+    Histogram windowFaults;
+
+    // Checked before the frames are allocated, which a count below one would break
+    static int validFramesN(const int& framesN) {
+        if (framesN < 1) {
+            throw std::invalid_argument("There must be at least one frame.");
+        }
 
-    // Returns frame of the given page
-    int addPage(const int& pageNumber, const std::string& content = "anything") {
-        int frame = this->history;
+        return framesN;
+    }
 
-        // If the page table's full, remove a page according to the MMU's algorithm and catch the frame that it was using
-        if (this->pages.size() >= this->ram.maxFrames()) {
-            frame = this->removePage();
+    void addProcess(const int& pid) {
+        if (pid < 0 || pid >= 1 << (64 - PAGE_KEY_BITS)) {
+            throw std::invalid_argument("Process ids must be from 0 to 65535.");
         }
 
-        // Update the RAM with the given content
-        this->ram.setFrame(this->getPhysicalAddress(frame), content);
+        if (pid >= (int)this->seen.size()) {
+            this->seen.resize(pid + 1, false);
+            this->residents.resize(pid + 1, 0);
+            this->processFaults.resize(pid + 1, 0);
+            this->pageTables.resize(pid + 1);
 
-        // And add the new page to the table
-        Page newPage = { pageNumber, frame, true, false, history };
-        this->pages.push_back(newPage);
+            if (this->local) {
+                this->policies.resize(pid + 1);
+            }
+            while (this->workingSetWindow > 0 && (int)this->workingSets.size() <= pid) {
+                this->workingSets.emplace_back(this->workingSetWindow);
+            }
+        }
 
-        return frame;
-    }
+        if (this->local && this->policies[pid] == nullptr) {
+            this->policies[pid] = makePolicy(this->algorithm, this->framesN);
+        }
 
-    long getPhysicalAddress(const int& pageNumber) {
-        return pageNumber * this->frameSize;
+        this->seen[pid] = true;
+        this->_processesN += 1;
     }
 
-    int removePage() {
-        int frame;
-
-        if (this->algorithm == "fifo") {
-            frame = this->pages[0].frame;
+    // Returns frame of the given page
+    int addPage(const int& pid, const PageNumber& pageNumber, const int& nextUse, const bool& write, const std::string_view& content = "anything") {
+        // Until the RAM fills up, frames are handed out in order
+        int frame = this->residentsN;
 
-            this->pages.erase(this->pages.begin());
-        } else if (this->algorithm == "otm") {
-            int pagesN = this->pages.size();
+        // If it's full, remove a page according to the MMU's algorithm and catch the frame that it was using
+        if (this->residentsN >= this->framesN) {
+            frame = this->removePage(pid, pageNumber);
+        }
 
-            // Get the number of all pages currently in the table
-            std::vector<int> pages;
-            for (Page page : this->pages) {
-                pages.push_back(page.index);
-            }
+        // Update the RAM with the given content
+        this->ram.setFrame(frame, content);
 
-            std::vector<int> pagesUsed(pagesN, 0);
+        // And add the new page to the table
+        this->pages[frame] = { pageNumber, frame, true, write, history, history, nextUse, pid };
+        if (this->_table) {
+            this->_table->set(pid, pageNumber, frame);
+        } else {
+            this->pageTables[pid].set(pageNumber, frame);
+        }
+        this->policy(pid)->loaded(this->pages[frame]);
 
-            int queueSize = this->queue.size();
-            // Find when each page is last used in the queue
-            for (int i = 0; i < pagesN; i++) {
-                int page = pages[i];
+        this->residentsN += 1;
+        this->residents[pid] += 1;
 
-                for (int j = this->history; j < queueSize; j++) {
-                    // If the current page in the queue is the one we're looking for and we found a later use of it
-                    if (this->queue[j] == page && pagesUsed[i] < j) {
-                        pagesUsed[i] = j;
-                    }
-                }
-            }
+        return frame;
+    }
 
-            // Find the last used page's index only if the first one isn't useless already
-            int lastUsedPageIndex = 0;
-            if (pagesUsed[lastUsedPageIndex] != 0) {
-                for (int i = 1; i < pagesN; i++) {
-                    // And quit as soon as there's an useless one
-                    if (pagesUsed[i] == 0) {
-                        lastUsedPageIndex = i;
-                        break;
-                    }
-
-                    if (pagesUsed[i] > pagesUsed[lastUsedPageIndex]) {
-                        lastUsedPageIndex = i;
-                    }
-                }
-            }
+    ReplacementPolicy* policy(const int& pid) {
+        return this->policies[this->local ? pid : 0].get();
+    }
 
-            // Retrieve its frame
-            frame = this->pages[lastUsedPageIndex].frame;
+    // Frees a frame for the given page of the given process
+    int removePage(const int& pid, const PageNumber& pageNumber) {
+        int owner = pid;
 
-            // And erase it from the table
-            this->pages.erase(this->pages.begin() + lastUsedPageIndex);
-        } else {
-            int lruPage[2] = { 0, std::numeric_limits<int>::max() };
+        // A process below its share of the frames takes one from whoever has the most
+        if (this->local && this->residents[pid] < std::max(1, this->framesN / this->_processesN)) {
+            owner = std::max_element(this->residents.begin(), this->residents.end()) - this->residents.begin();
+        }
 
-            for (int i = 0; i < (int)this->pages.size(); i++) {
-                Page page = this->pages[i];
+        int frame = this->policy(owner)->evict(pageKey(pid, pageNumber));
+        if (frame == NO_FRAME || !this->pages[frame].valid || (this->local && this->pages[frame].pid != owner)) {
+            throw std::logic_error("The " + this->algorithm + " policy evicted a frame its process didn't have.");
+        }
+        const Page& page = this->pages[frame];
 
-                if (page.accessed < lruPage[1]) {
-                    lruPage[0] = i;
-                    lruPage[1] = page.accessed;
-                }
-            }
+        // Its changes have to reach the disk before the frame's reused
+        if (page.dirty) {
+            this->_writeBacks += 1;
+        }
 
-            frame = this->pages[lruPage[0]].frame;
+        if (this->_tlb) {
+            this->_tlb->shootdown(page.pid, page.index);
+        }
 
-            this->pages.erase(this->pages.begin() + lruPage[0]);
+        // Erase its page from its process' table
+        if (this->_table) {
+            this->_table->remove(page.pid, page.index);
+        } else {
+            this->pageTables[page.pid].remove(page.index);
         }
+        this->pages[frame].valid = false;
+
+        this->residentsN -= 1;
+        this->residents[page.pid] -= 1;
 
         this->ram.cleanFrame(frame);
 
@@ -126,40 +232,149 @@ private:
 
 public:
     // Constructors
-    MemoryManagementUnit(const int& framesN, const std::string& algorithm, const std::vector<int>& queue, const int& frameSize = 1) : algorithm(algorithm), frameSize(frameSize), history(0), _pageFaults(0), queue(queue), ram(framesN* frameSize) {
-        if (!std::any_of(supportedAlgorithms.begin(), supportedAlgorithms.end(), [this](std::string supportedAlgorithm) {return this->algorithm == supportedAlgorithm;})) {
+    MemoryManagementUnit(const int& framesN, const std::string& algorithm, const int& frameSize = 1) : MemoryManagementUnit(framesN, algorithm, { { 0, 1, "lru" }, { "hash", 0, 32 }, false, 0, 0 }, frameSize) {}
+    MemoryManagementUnit(const int& framesN, const std::string& algorithm, const MmuOptions& options, const int& frameSize = 1) : algorithm(algorithm), framesN(validFramesN(framesN)), history(0), pageNumberBits(options.table.pageNumberBits), local(options.local), _pageFaults(0), pages(framesN), ram(framesN, frameSize), workingSetWindow(options.workingSetWindow), faultWindow(options.faultWindow) {
+        if (std::find(supportedAlgorithms.begin(), supportedAlgorithms.end(), algorithm) == supportedAlgorithms.end()) {
             throw std::invalid_argument(unsupportedAlgorithmMessage);
         }
+
+        if (this->pageNumberBits < 1 || this->pageNumberBits > PAGE_KEY_BITS) {
+            throw std::invalid_argument("Virtual page numbers must have from 1 to 48 bits.");
+        }
+
+        // Local replacement makes each process' policy when it first shows up
+        if (!this->local) {
+            this->policies.push_back(makePolicy(algorithm, framesN));
+        }
+
+        if (options.tlb.entriesN > 0) {
+            this->_tlb = std::make_unique<TranslationLookasideBuffer>(options.tlb);
+        }
+
+        this->_table = makeTable(options.table, framesN);
     }
 
-    std::string getPage(const int& pageNumber) {
-        int frame;
-        bool storedFrame = false;
+    // Returns a view of the page's frame, valid until it's evicted. OTM needs to know when the page will be referenced next. Writing makes the page dirty
+    std::string_view getPage(const PageNumber& pageNumber, const int& nextUse = NO_NEXT_USE, const bool& write = false, const int& pid = 0) {
+        if (pid >= (int)this->seen.size() || !this->seen[pid]) {
+            this->addProcess(pid);
+        }
 
-        // Check if the page's already present
-        for (Page& page : this->pages) {
-            if (page.index == pageNumber) {
-                page.accessed = this->history;
-                frame = page.frame;
+        checkPageNumber(pageNumber, this->pageNumberBits);
 
-                storedFrame = true;
-                break;
-            }
+        // Check if the page's already present, asking the TLB first
+        int frame = this->_tlb ? this->_tlb->lookup(pid, pageNumber) : NO_FRAME;
+        bool cached = frame != NO_FRAME;
+
+        if (!cached) {
+            frame = this->_table ? this->_table->get(pid, pageNumber) : this->pageTables[pid].get(pageNumber);
         }
 
-        // If it isn't, add to the number of page faults and then add the page
-        if (!storedFrame) {
-            _pageFaults += 1;
+        bool fault = frame == NO_FRAME;
+        if (!fault) {
+            Page& page = this->pages[frame];
+            page.accessed = this->history;
+            page.nextUse = nextUse;
+            page.dirty = page.dirty || write;
 
-            frame = this->addPage(pageNumber);
+            this->policy(pid)->accessed(page);
+        } else {
+            // If it isn't, add to the number of page faults and then add the page
+            this->_pageFaults += 1;
+            this->processFaults[pid] += 1;
+
+            frame = this->addPage(pid, pageNumber, nextUse, write);
+        }
+
+        if (this->_tlb && !cached) {
+            this->_tlb->insert(pid, pageNumber, frame);
+        }
+
+        if (this->workingSetWindow > 0) {
+            WorkingSet& workingSet = this->workingSets[pid];
+
+            this->workingSetsTotal -= workingSet.size();
+            workingSet.access(pageNumber, fault);
+            this->workingSetsTotal += workingSet.size();
+
+            this->workingSetsSum += this->workingSetsTotal;
+            if (this->workingSetsTotal > this->framesN) {
+                this->thrashingN += 1;
+            }
         }
 
         this->history += 1;
+        if (this->faultWindow > 0 && this->history % this->faultWindow == 0) {
+            this->windowFaults.add(this->_pageFaults - this->windowStartFaults);
+            this->windowStartFaults = this->_pageFaults;
+        }
 
-        return this->ram.getFrame(this->getPhysicalAddress(frame));
+        return this->ram.getFrame(frame);
     }
 
-    int pageFaults() {
+    // Average over every reference of the sum of every process' working set
+    double averageWorkingSets() const {
+        return this->history > 0 ? (double)this->workingSetsSum / this->history : 0;
+    }
+
+    // Share of the references that faulted in a window, at the given percentile of every full window so far
+    double pageFaultRate(const double& percent) const {
+        return this->faultWindow > 0 ? (double)this->windowFaults.percentile(percent) / this->faultWindow : 0;
+    }
+
+    int pageFaults() const {
         return this->_pageFaults;
     }
+
+    // Full windows the page fault rate was measured over
+    long pageFaultWindows() const {
+        return this->windowFaults.count();
+    }
+
+    // Processes that referenced anything, which are the ones below seen.size() with seen set
+    int processesN() const {
+        return this->_processesN;
+    }
+
+    int processPageFaults(const int& pid) const {
+        return pid < (int)this->processFaults.size() ? this->processFaults[pid] : 0;
+    }
+
+    // Pids go up to this, though some of them may have never been seen
+    int processesEnd() const {
+        return this->seen.size();
+    }
+
+    bool processSeen(const int& pid) const {
+        return pid < (int)this->seen.size() && this->seen[pid];
+    }
+
+    // Time spent waiting on page faults and write-backs
+    long stallTime(const CostModel& costs) const {
+        return this->_pageFaults * costs.faultLatency + this->_writeBacks * costs.writeBackLatency;
+    }
+
+    // Null for the hash table
+    const TranslationTable* table() const {
+        return this->_table.get();
+    }
+
+    // Share of references after which the working sets, together, didn't fit in the RAM
+    double thrashingRate() const {
+        return this->history > 0 ? (double)this->thrashingN / this->history : 0;
+    }
+
+    // Null when there's no TLB
+    const TranslationLookasideBuffer* tlb() const {
+        return this->_tlb.get();
+    }
+
+    // Null when working sets aren't tracked
+    const WorkingSet* workingSet(const int& pid) const {
+        return pid < (int)this->workingSets.size() ? &this->workingSets[pid] : nullptr;
+    }
+
+    int writeBacks() const {
+        return this->_writeBacks;
+    }
 };
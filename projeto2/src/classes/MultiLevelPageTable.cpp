@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "./TranslationTable.cpp"
+
+// Radix tree over the page number's bits, one per process, every level below the root taking the same number of them. Roots are allocated on a process' first mapping, and other nodes once a page under them is mapped, from a single pool shared by every process, and given back once they're empty
+class MultiLevelPageTable : public TranslationTable {
+private:
+    static constexpr int EMPTY = -1;
+
+    int levelsN;
+    // Bits taken by each level below the root
+    int levelBits;
+    std::size_t rootSize;
+    // Each process' root, empty until it maps something
+    std::vector<std::vector<int>> roots;
+    // Nodes below the root, each a block of 1 << levelBits entries holding either the next node or, at the last level, a frame
+    std::vector<int> pool;
+    // Mapped entries in each node of the pool
+    std::vector<int> counts;
+    std::vector<int> freeNodes;
+    int nodesN = 0;
+    int peakNodesN = 0;
+    std::size_t _size = 0;
+
+    std::size_t index(const PageNumber& pageNumber, const int& level) const {
+        PageNumber bits = pageNumber >> (this->levelBits * (this->levelsN - 1 - level));
+
+        return level == 0 ? bits : bits & (((PageNumber)1 << this->levelBits) - 1);
+    }
+
+    // Where a node's entries start, the process' root being node -1
+    int* entries(const int& pid, const int& node) {
+        return node < 0 ? this->roots[pid].data() : this->pool.data() + ((std::size_t)node << this->levelBits);
+    }
+
+    int allocate() {
+        int node;
+
+        if (!this->freeNodes.empty()) {
+            node = this->freeNodes.back();
+            this->freeNodes.pop_back();
+        } else {
+            node = this->counts.size();
+            this->counts.push_back(0);
+            this->pool.resize(this->pool.size() + ((std::size_t)1 << this->levelBits), EMPTY);
+        }
+
+        this->nodesN += 1;
+        this->peakNodesN = std::max(this->peakNodesN, this->nodesN);
+
+        return node;
+    }
+
+public:
+    // Constructors
+    MultiLevelPageTable(const int& levelsN, const int& pageNumberBits) : levelsN(levelsN) {
+        if (levelsN < 2 || levelsN > 4) {
+            throw std::invalid_argument("Multilevel page tables must have from 2 to 4 levels.");
+        }
+        if (pageNumberBits < levelsN || pageNumberBits > PAGE_KEY_BITS) {
+            throw std::invalid_argument("Page numbers must have at least a bit per level, and at most 48.");
+        }
+
+        this->levelBits = (pageNumberBits + levelsN - 1) / levelsN;
+        // Every node below the root is allocated whole, so wide address spaces need more levels
+        if (this->levelBits > 20) {
+            throw std::invalid_argument("Page table levels can't take more than 20 bits each. Use more levels.");
+        }
+        this->rootSize = (std::size_t)1 << (pageNumberBits - this->levelBits * (levelsN - 1));
+    }
+
+    int get(const int& pid, const PageNumber& pageNumber) override {
+        int node = -1;
+        this->walks += 1;
+
+        if (pid >= (int)this->roots.size() || this->roots[pid].empty()) {
+            return EMPTY;
+        }
+
+        for (int level = 0; level < this->levelsN; level++) {
+            this->walkSteps += 1;
+            node = this->entries(pid, node)[this->index(pageNumber, level)];
+
+            if (node == EMPTY) {
+                return EMPTY;
+            }
+        }
+
+        // Which, at the last level, is the frame
+        return node;
+    }
+
+    void set(const int& pid, const PageNumber& pageNumber, const int& frame) override {
+        int node = -1;
+
+        if (pid >= (int)this->roots.size()) {
+            this->roots.resize(pid + 1);
+        }
+        if (this->roots[pid].empty()) {
+            this->roots[pid].assign(this->rootSize, EMPTY);
+        }
+
+        for (int level = 0; level < this->levelsN - 1; level++) {
+            std::size_t i = this->index(pageNumber, level);
+
+            if (this->entries(pid, node)[i] == EMPTY) {
+                // Allocating may move the pool, so the parent's entries are looked up again after
+                int child = this->allocate();
+
+                this->entries(pid, node)[i] = child;
+                if (node >= 0) {
+                    this->counts[node] += 1;
+                }
+            }
+
+            node = this->entries(pid, node)[i];
+        }
+
+        int& entry = this->entries(pid, node)[this->index(pageNumber, this->levelsN - 1)];
+        if (entry == EMPTY) {
+            this->counts[node] += 1;
+            this->_size += 1;
+        }
+        entry = frame;
+    }
+
+    void remove(const int& pid, const PageNumber& pageNumber) override {
+        int path[4] = { -1 };
+
+        if (pid >= (int)this->roots.size() || this->roots[pid].empty()) {
+            return;
+        }
+
+        for (int level = 1; level < this->levelsN; level++) {
+            path[level] = this->entries(pid, path[level - 1])[this->index(pageNumber, level - 1)];
+
+            if (path[level] == EMPTY) {
+                return;
+            }
+        }
+
+        int& entry = this->entries(pid, path[this->levelsN - 1])[this->index(pageNumber, this->levelsN - 1)];
+        if (entry == EMPTY) {
+            return;
+        }
+        entry = EMPTY;
+        this->_size -= 1;
+
+        // Free the nodes left empty, bottom up
+        for (int level = this->levelsN - 1; level >= 1; level--) {
+            int node = path[level];
+
+            this->counts[node] -= 1;
+            if (this->counts[node] > 0) {
+                break;
+            }
+
+            this->freeNodes.push_back(node);
+            this->nodesN -= 1;
+            this->entries(pid, path[level - 1])[this->index(pageNumber, level - 1)] = EMPTY;
+        }
+    }
+
+    std::size_t size() const override {
+        return this->_size;
+    }
+
+    long footprint() const override {
+        long rootsN = std::count_if(this->roots.begin(), this->roots.end(), [](const std::vector<int>& root) { return !root.empty(); });
+
+        return (rootsN * (long)this->rootSize + ((long)this->peakNodesN << this->levelBits)) * ENTRY_SIZE;
+    }
+};
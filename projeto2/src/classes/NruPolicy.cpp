@@ -0,0 +1,83 @@
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "./ReplacementPolicy.cpp"
+
+// Evicts a random page from the lowest non-empty class, classes being (referenced, dirty) from (0, 0) to (1, 1). Reference bits are cleared every framesN references, as a clock interrupt would
+class NruPolicy : public ReplacementPolicy {
+private:
+    // Frames in each class, and where each frame is in its class
+    std::vector<int> classes[4];
+    std::vector<int> classOf;
+    std::vector<int> position;
+    std::vector<bool> referenced;
+    int referencesN = 0;
+    // Seeded so runs are reproducible
+    std::mt19937 generator;
+
+    void add(const int& frame, const int& pageClass) {
+        this->classOf[frame] = pageClass;
+        this->position[frame] = this->classes[pageClass].size();
+        this->classes[pageClass].push_back(frame);
+    }
+
+    void remove(const int& frame) {
+        std::vector<int>& members = this->classes[this->classOf[frame]];
+
+        // Fill its place with the class' last frame
+        members[this->position[frame]] = members.back();
+        this->position[members.back()] = this->position[frame];
+        members.pop_back();
+    }
+
+    void reference(const Page& page) {
+        this->referenced[page.frame] = true;
+        this->remove(page.frame);
+        this->add(page.frame, 2 + page.dirty);
+
+        this->referencesN += 1;
+        if (this->referencesN % (int)this->referenced.size() == 0) {
+            this->clearReferences();
+        }
+    }
+
+    void clearReferences() {
+        for (int referencedClass = 2; referencedClass < 4; referencedClass++) {
+            std::vector<int> members;
+            members.swap(this->classes[referencedClass]);
+
+            for (int frame : members) {
+                this->referenced[frame] = false;
+                this->add(frame, referencedClass - 2);
+            }
+        }
+    }
+
+public:
+    // Constructors
+    explicit NruPolicy(const int& framesN) : classOf(framesN, 0), position(framesN, 0), referenced(framesN, false), generator(0) {}
+
+    void loaded(const Page& page) override {
+        this->add(page.frame, 0);
+        this->reference(page);
+    }
+
+    void accessed(const Page& page) override {
+        this->reference(page);
+    }
+
+    int evict(const long&) override {
+        for (std::vector<int>& members : this->classes) {
+            if (!members.empty()) {
+                int frame = members[std::uniform_int_distribution<int>(0, members.size() - 1)(this->generator)];
+                this->remove(frame);
+
+                return frame;
+            }
+        }
+
+        return NO_FRAME;
+    }
+};
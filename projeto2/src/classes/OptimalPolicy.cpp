@@ -0,0 +1,38 @@
+#pragma once
+
+#include <iterator>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "./ReplacementPolicy.cpp"
+
+// Evicts the page used again the furthest in the future, or the oldest of the ones that won't be. Takes logarithmic time per reference
+class OptimalPolicy : public ReplacementPolicy {
+private:
+    // Resident pages by (next use, -load time, frame), so the last one is the one to evict
+    std::set<std::tuple<int, int, int>> nextUses;
+    // Each frame's key in nextUses
+    std::vector<std::tuple<int, int, int>> keys;
+
+public:
+    // Constructors
+    explicit OptimalPolicy(const int& framesN) : keys(framesN) {}
+
+    void loaded(const Page& page) override {
+        this->keys[page.frame] = { page.nextUse, -page.loaded, page.frame };
+        this->nextUses.insert(this->keys[page.frame]);
+    }
+
+    void accessed(const Page& page) override {
+        this->nextUses.erase(this->keys[page.frame]);
+        this->loaded(page);
+    }
+
+    int evict(const long&) override {
+        int frame = std::get<2>(*this->nextUses.rbegin());
+        this->nextUses.erase(std::prev(this->nextUses.end()));
+
+        return frame;
+    }
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// Virtual page numbers, which take more than 32 bits in 48 or 64-bit address spaces
+typedef std::uint64_t PageNumber;
+
+// Bits of a page number that fit in a pageKey, the rest of it holding the process
+const int PAGE_KEY_BITS = 48;
+
+struct Page {
+    PageNumber index;
+    int frame;
+    bool valid;
+    bool dirty;
+    int accessed;
+    int loaded;
+    // When it'll be used again (only known to OTM)
+    int nextUse;
+    // Process whose address space it belongs to
+    int pid;
+};
+
+// Throws unless the page number fits in the given number of bits
+void checkPageNumber(const PageNumber& pageNumber, const int& bits) {
+    if (pageNumber >> bits != 0) {
+        throw std::invalid_argument("Page " + std::to_string(pageNumber) + " is outside the " + std::to_string(bits) + "-bit virtual page numbers.");
+    }
+}
+
+// End of a frame list
+const int NO_FRAME = -1;
+
+// Identifies a page across every process' address space, as long as its number has at most PAGE_KEY_BITS bits and its process at most 64 - PAGE_KEY_BITS
+long pageKey(const int& pid, const PageNumber& pageNumber) {
+    return (long)((std::uint64_t)pid << PAGE_KEY_BITS | pageNumber);
+}
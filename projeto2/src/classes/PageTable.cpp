@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "./Page.cpp"
+
+// Maps page numbers to frames with open addressing (linear probing), so a lookup is usually a single cache line
+class PageTable {
+private:
+    struct Slot {
+        PageNumber pageNumber;
+        int frame;
+    };
+
+    // Frame of empty slots
+    static constexpr int EMPTY = -1;
+
+    // Capacity is always a power of two, kept at most half full
+    std::vector<Slot> slots;
+    std::size_t _size = 0;
+    // Bits of the hash dropped to index the slots
+    int shift = 64;
+
+    std::size_t home(const PageNumber& pageNumber) const {
+        // Fibonacci hashing spreads sequential page numbers around the table, its top bits depending on every bit of the page number
+        return pageNumber * 11400714819323198485u >> this->shift;
+    }
+
+    void resize(const std::size_t& capacity) {
+        this->slots.assign(capacity, { 0, EMPTY });
+        this->shift = 64 - __builtin_ctzl(capacity);
+    }
+
+    void grow() {
+        std::vector<Slot> old = std::move(this->slots);
+        this->resize(old.size() * 2);
+        this->_size = 0;
+
+        for (const Slot& slot : old) {
+            if (slot.frame != EMPTY) {
+                this->set(slot.pageNumber, slot.frame);
+            }
+        }
+    }
+
+public:
+    // Constructors
+    PageTable() : PageTable(16) {}
+    explicit PageTable(const std::size_t& expectedPages) {
+        std::size_t capacity = 16;
+        while (capacity < expectedPages * 2) {
+            capacity *= 2;
+        }
+
+        this->resize(capacity);
+    }
+
+    // Returns the page's frame, or -1 if it isn't loaded
+    int get(const PageNumber& pageNumber) const {
+        for (std::size_t i = this->home(pageNumber);; i = (i + 1) & (this->slots.size() - 1)) {
+            const Slot& slot = this->slots[i];
+
+            if (slot.frame == EMPTY || slot.pageNumber == pageNumber) {
+                return slot.frame;
+            }
+        }
+    }
+
+    void set(const PageNumber& pageNumber, const int& frame) {
+        if ((this->_size + 1) * 2 > this->slots.size()) {
+            this->grow();
+        }
+
+        std::size_t i = this->home(pageNumber);
+        while (this->slots[i].frame != EMPTY && this->slots[i].pageNumber != pageNumber) {
+            i = (i + 1) & (this->slots.size() - 1);
+        }
+
+        if (this->slots[i].frame == EMPTY) {
+            this->_size += 1;
+        }
+        this->slots[i] = { pageNumber, frame };
+    }
+
+    void remove(const PageNumber& pageNumber) {
+        std::size_t mask = this->slots.size() - 1, i = this->home(pageNumber);
+
+        while (this->slots[i].pageNumber != pageNumber || this->slots[i].frame == EMPTY) {
+            if (this->slots[i].frame == EMPTY) {
+                return;
+            }
+
+            i = (i + 1) & mask;
+        }
+
+        // Shift later entries of the same probe run back into the hole, so lookups never need tombstones
+        for (std::size_t j = (i + 1) & mask; this->slots[j].frame != EMPTY; j = (j + 1) & mask) {
+            std::size_t target = this->home(this->slots[j].pageNumber);
+
+            // Only move it if its home isn't cyclically in (i, j]
+            if (((j - target) & mask) >= ((j - i) & mask)) {
+                this->slots[i] = this->slots[j];
+                i = j;
+            }
+        }
+
+        this->slots[i].frame = EMPTY;
+        this->_size -= 1;
+    }
+
+    std::size_t size() const {
+        return this->_size;
+    }
+};
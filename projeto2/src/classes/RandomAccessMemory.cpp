@@ -1,41 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
 #include <stdexcept>
-#include <string>
-#include <tuple>
+#include <string_view>
 #include <vector>
 
+// Hands out memory aligned to (host) pages, so every simulated frame of a page-sized RAM sits in exactly one of them
+template <typename T>
+struct PageAlignedAllocator {
+    typedef T value_type;
+
+    static constexpr std::size_t alignment = 4096;
+
+    PageAlignedAllocator() {}
+    template <typename U>
+    PageAlignedAllocator(const PageAlignedAllocator<U>&) {}
+
+    T* allocate(const std::size_t& n) {
+        // aligned_alloc needs the size to be a multiple of the alignment
+        std::size_t size = (n * sizeof(T) + alignment - 1) / alignment * alignment;
+        void* memory = std::aligned_alloc(alignment, size);
+
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* memory, const std::size_t&) {
+        std::free(memory);
+    }
+
+    template <typename U>
+    bool operator==(const PageAlignedAllocator<U>&) const {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const PageAlignedAllocator<U>&) const {
+        return false;
+    }
+};
+
+// Byte-addressable memory split into equally sized frames, all in a single buffer
 class RandomAccessMemory {
 private:
-    std::vector<std::string> frames;
+    std::vector<char, PageAlignedAllocator<char>> bytes;
+    std::size_t frameSize;
+    // Whether something was written to each frame since it was last cleaned
+    std::vector<bool> used;
 
 public:
     // Constructors
-    RandomAccessMemory(const long& framesN) : frames(framesN) {}
+    RandomAccessMemory(const long& framesN, const long& frameSize = 1) : bytes(framesN * frameSize, 0), frameSize(frameSize), used(framesN, false) {}
 
     void cleanFrame(const long& frame) {
-        this->frames[frame] = "";
+        std::memset(this->bytes.data() + frame * this->frameSize, 0, this->frameSize);
+        this->used[frame] = false;
     }
 
-    std::string getFrame(const int& frame) {
-        return this->frames[frame];
+    // Frame's contents, without copying them
+    std::string_view getFrame(const long& frame) const {
+        return std::string_view(this->bytes.data() + frame * this->frameSize, this->frameSize);
     }
 
-    std::size_t maxFrames() const {
-        return frames.size();
-    }
-
-    /* Returns true in case there was content previously set to the frame */
-    std::tuple<bool, std::string> setFrame(const long& frame, const std::string& content) {
-        if (frame > (int)this->frames.size() - 1) {
+    /* Writes content to the frame in place, cutting it to the frame's size. Returns true in case there was content previously set to the frame */
+    bool setFrame(const long& frame, const std::string_view& content) {
+        if (frame > (long)this->used.size() - 1) {
             throw std::invalid_argument("The given frame is bigger than the RAM size.");
         }
 
-        std::string oldContent = this->frames[frame];
-        this->frames[frame] = content;
+        char* start = this->bytes.data() + frame * this->frameSize;
+        std::size_t length = std::min(content.size(), this->frameSize);
 
-        if (oldContent != "") {
-            return { true, oldContent };
-        }
+        std::memcpy(start, content.data(), length);
+        std::memset(start + length, 0, this->frameSize - length);
+
+        bool wasUsed = this->used[frame];
+        this->used[frame] = true;
 
-        return { false, content };
+        return wasUsed;
     }
 };
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../../comum/Random.cpp"
+
+struct ReferenceConfig {
+    long referencesN;
+    int framesN;
+    // Which pages each process references: "uniform:PAGES", "zipf:S:PAGES", "loop:PAGES" or "phase:PAGES:SET:PERIOD"
+    std::string locality;
+    // Share of the references that are writes
+    double writeRatio;
+    int processesN;
+    // References each process makes before the next one's turn
+    int sliceLength;
+    std::uint64_t seed;
+};
+
+// Generates a synthetic reference trace, one reference at a time, so it can be streamed to disk. Every process has its own pages, referenced with the same kind of locality:
+//   uniform: any of PAGES pages
+//   zipf:    page i with probability proportional to 1 / (i + 1)^S, so a few pages get most references
+//   loop:    PAGES pages in order, over and over, which LRU and FIFO fault on every time PAGES is above the frames
+//   phase:   SET consecutive pages out of PAGES, moving somewhere else every PERIOD references
+// The same seed always gives the same trace
+class ReferenceGenerator {
+private:
+    ReferenceConfig config;
+    std::string kind;
+    long pagesN = 0;
+    // Zipf's exponent, or phase's set size and period
+    double exponent = 0;
+    long setSize = 0;
+    long period = 0;
+    // Zipf's cumulative weights
+    std::vector<double> cumulative;
+    Random random;
+    long generatedN = 0;
+    // Per process, where its loop or phase is
+    std::vector<long> positions;
+    std::vector<long> phaseAges;
+
+    long nextPage(const int& pid) {
+        if (this->kind == "uniform") {
+            return this->random.uniformInt(this->pagesN);
+        } else if (this->kind == "zipf") {
+            double target = this->random.uniform() * this->cumulative.back();
+
+            return std::upper_bound(this->cumulative.begin(), this->cumulative.end(), target) - this->cumulative.begin();
+        } else if (this->kind == "loop") {
+            long page = this->positions[pid];
+            this->positions[pid] = (page + 1) % this->pagesN;
+
+            return page;
+        }
+
+        // Phase moves its set once it's been in the same place for a whole period
+        if (this->phaseAges[pid] % this->period == 0) {
+            this->positions[pid] = this->random.uniformInt(this->pagesN - this->setSize + 1);
+        }
+        this->phaseAges[pid] += 1;
+
+        return this->positions[pid] + this->random.uniformInt(this->setSize);
+    }
+
+public:
+    explicit ReferenceGenerator(const ReferenceConfig& config) : config(config), random(config.seed), positions(std::max(config.processesN, 1), 0), phaseAges(std::max(config.processesN, 1), 0) {
+        std::istringstream stream(config.locality);
+        std::string field;
+        std::vector<double> params;
+
+        std::getline(stream, this->kind, ':');
+        while (std::getline(stream, field, ':')) {
+            params.push_back(std::stod(field));
+        }
+
+        std::size_t expected = this->kind == "zipf" ? 2 : this->kind == "phase" ? 3 : 1;
+        if ((this->kind != "uniform" && this->kind != "zipf" && this->kind != "loop" && this->kind != "phase") || params.size() != expected) {
+            throw std::invalid_argument("Only uniform:PAGES, zipf:S:PAGES, loop:PAGES and phase:PAGES:SET:PERIOD localities are supported.");
+        }
+
+        if (this->kind == "zipf") {
+            this->exponent = params[0];
+            this->pagesN = params[1];
+        } else {
+            this->pagesN = params[0];
+        }
+
+        if (this->kind == "phase") {
+            this->setSize = params[1];
+            this->period = params[2];
+
+            if (this->setSize < 1 || this->setSize > this->pagesN || this->period < 1) {
+                throw std::invalid_argument("Phases need a set of 1 to PAGES pages and a positive period.");
+            }
+        }
+
+        if (this->pagesN < 1) {
+            throw std::invalid_argument("There must be at least one page.");
+        }
+
+        if (config.processesN < 1 || config.sliceLength < 1) {
+            throw std::invalid_argument("There must be at least one process, each making at least one reference at a time.");
+        }
+
+        if (this->kind == "zipf") {
+            this->cumulative.resize(this->pagesN);
+
+            double total = 0;
+            for (long page = 0; page < this->pagesN; page++) {
+                total += 1 / std::pow(page + 1, this->exponent);
+                this->cumulative[page] = total;
+            }
+        }
+    }
+
+    int framesN() const {
+        return this->config.framesN;
+    }
+
+    // Gets the next reference. Returns false once every one was generated
+    bool next(int& pageNumber, bool& write, int& pid) {
+        if (this->generatedN >= this->config.referencesN) {
+            return false;
+        }
+
+        pid = this->generatedN / this->config.sliceLength % this->config.processesN;
+        pageNumber = this->nextPage(pid);
+        write = this->random.uniform() < this->config.writeRatio;
+        this->generatedN += 1;
+
+        return true;
+    }
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./Page.cpp"
+#include "../../../comum/TraceReader.cpp"
+
+// Never used again (or, when streaming, not within the lookahead)
+const int NO_NEXT_USE = std::numeric_limits<int>::max();
+
+struct Reference {
+    PageNumber pageNumber;
+    // Index of the next reference to the same page
+    int nextUse;
+    bool write;
+    int pid;
+};
+
+struct Trace {
+    int framesN;
+    std::vector<PageNumber> queue;
+    // Whether each reference writes to its page
+    std::vector<bool> writes;
+    // Process of each reference, empty while they're all from process 0
+    std::vector<int> pids;
+    // Where each reference's page is used next
+    std::vector<int> nextUses;
+
+    void add(const PageNumber& pageNumber, const bool& write, const int& pid) {
+        // Only once a process other than 0 shows up
+        if (pid != 0 || !this->pids.empty()) {
+            this->pids.resize(this->queue.size(), 0);
+            this->pids.push_back(pid);
+        }
+
+        this->queue.push_back(pageNumber);
+        this->writes.push_back(write);
+    }
+};
+
+// Finds every reference's next occurrence (of the same page of the same process) in a single backwards pass
+std::vector<int> findNextUses(const std::vector<PageNumber>& queue, const std::vector<int>& pids = {}) {
+    std::unordered_map<long, int> nextSeen;
+    std::vector<int> nextUses(queue.size());
+
+    for (int i = queue.size() - 1; i >= 0; i--) {
+        long key = pageKey(pids.empty() ? 0 : pids[i], queue[i]);
+        auto found = nextSeen.find(key);
+
+        nextUses[i] = found == nextSeen.end() ? NO_NEXT_USE : found->second;
+        nextSeen[key] = i;
+    }
+
+    return nextUses;
+}
+
+// Parses a reference's line (page number, then optionally whether it's a write and its process) into its page, taking pageShift bits off virtual addresses
+Reference parseReference(const std::uint64_t* info, const int& infoN, const int& pageShift) {
+    return { info[0] >> pageShift, NO_NEXT_USE, infoN > 1 && info[1] != 0, infoN > 2 ? (int)info[2] : 0 };
+}
+
+// Walks a trace that's already in memory
+class TraceReferences {
+private:
+    std::size_t current = 0;
+    const Trace& trace;
+
+public:
+    explicit TraceReferences(const Trace& trace) : trace(trace) {}
+
+    int framesN() const {
+        return this->trace.framesN;
+    }
+
+    // Gets the next reference. Returns false when there are none left
+    bool next(Reference& reference) {
+        if (this->current >= this->trace.queue.size()) {
+            return false;
+        }
+
+        reference.pageNumber = this->trace.queue[this->current];
+        reference.nextUse = this->trace.nextUses.empty() ? NO_NEXT_USE : this->trace.nextUses[this->current];
+        reference.write = this->trace.writes[this->current];
+        reference.pid = this->trace.pids.empty() ? 0 : this->trace.pids[this->current];
+        this->current += 1;
+
+        return true;
+    }
+};
+
+// Reads references straight from a trace file as they're needed. Next uses are only known within a window of the following `lookahead` references, which is as much of the trace as is kept in memory
+class StreamedReferences {
+private:
+    int _framesN = 0;
+    // Index of the window's first reference
+    int first = 0;
+    // Last occurrence of every page in the window
+    std::unordered_map<long, int> lastSeen;
+    int lookahead;
+    // References are virtual addresses of pages this many bits long, if it's not 0
+    int pageShift;
+    TraceReader reader;
+    // Circular window of the upcoming references, by index % lookahead
+    std::vector<Reference> window;
+    int windowN = 0;
+
+    // Reads a reference into the end of the window, returns false at the end of the file
+    bool read() {
+        std::uint64_t info[3];
+        int infoN = this->reader.readLine(info, 3);
+        if (infoN == 0) {
+            return false;
+        }
+
+        Reference reference = parseReference(info, infoN, this->pageShift);
+        long key = pageKey(reference.pid, reference.pageNumber);
+        int index = this->first + this->windowN;
+
+        auto found = this->lastSeen.find(key);
+        if (found != this->lastSeen.end()) {
+            this->window[found->second % this->lookahead].nextUse = index;
+            found->second = index;
+        } else {
+            this->lastSeen[key] = index;
+        }
+
+        this->window[index % this->lookahead] = reference;
+        this->windowN += 1;
+
+        return true;
+    }
+
+public:
+    StreamedReferences(const std::string& path, const int& lookahead, const int& pageShift = 0) : lookahead(lookahead > 0 ? lookahead : 1), pageShift(pageShift), reader(path, MEMORY_TRACE), window(this->lookahead) {
+        // The first line's the number of frames
+        this->reader.readLine(&this->_framesN, 1);
+
+        while (this->windowN < this->lookahead && this->read()) {}
+    }
+
+    int framesN() const {
+        return this->_framesN;
+    }
+
+    bool next(Reference& reference) {
+        if (this->windowN == 0) {
+            return false;
+        }
+
+        reference = this->window[this->first % this->lookahead];
+
+        // Forget it once it leaves the window, unless it shows up again in it
+        auto found = this->lastSeen.find(pageKey(reference.pid, reference.pageNumber));
+        if (found->second == this->first) {
+            this->lastSeen.erase(found);
+        }
+
+        this->first += 1;
+        this->windowN -= 1;
+        this->read();
+
+        return true;
+    }
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+#include "./Page.cpp"
+
+// Decides which resident page the MMU evicts. Every call concerns a single reference, and should take (amortized) constant time
+class ReplacementPolicy {
+public:
+    virtual ~ReplacementPolicy() {}
+
+    // The page was just loaded into its frame
+    virtual void loaded(const Page& page) = 0;
+    // The page was referenced while already resident
+    virtual void accessed(const Page& page) = 0;
+    // Picks the frame to free for the given (missing) page, identified by its pageKey. Its page is forgotten, and the new one is loaded into it right after
+    virtual int evict(const long& key) = 0;
+};
+
+// Doubly-linked list of frames, linked through arrays indexed by frame
+class FrameList {
+private:
+    std::vector<int> previous;
+    std::vector<int> next;
+    int first = NO_FRAME;
+    int last = NO_FRAME;
+    int _size = 0;
+
+public:
+    // Constructors
+    explicit FrameList(const int& framesN) : previous(framesN, NO_FRAME), next(framesN, NO_FRAME) {}
+
+    void append(const int& frame) {
+        this->previous[frame] = this->last;
+        this->next[frame] = NO_FRAME;
+
+        if (this->last != NO_FRAME) {
+            this->next[this->last] = frame;
+        } else {
+            this->first = frame;
+        }
+
+        this->last = frame;
+        this->_size += 1;
+    }
+
+    int front() const {
+        return this->first;
+    }
+
+    int size() const {
+        return this->_size;
+    }
+
+    void unlink(const int& frame) {
+        if (this->previous[frame] != NO_FRAME) {
+            this->next[this->previous[frame]] = this->next[frame];
+        } else {
+            this->first = this->next[frame];
+        }
+
+        if (this->next[frame] != NO_FRAME) {
+            this->previous[this->next[frame]] = this->previous[frame];
+        } else {
+            this->last = this->previous[frame];
+        }
+
+        this->_size -= 1;
+    }
+};
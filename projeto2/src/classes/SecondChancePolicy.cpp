@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include "./ReplacementPolicy.cpp"
+
+// FIFO that sends referenced pages back to the end of the queue, clearing their bit, instead of evicting them. Picks the same pages as Clock, moving list nodes instead of a hand
+class SecondChancePolicy : public ReplacementPolicy {
+private:
+    FrameList frames;
+    std::vector<bool> referenced;
+
+public:
+    // Constructors
+    explicit SecondChancePolicy(const int& framesN) : frames(framesN), referenced(framesN, false) {}
+
+    void loaded(const Page& page) override {
+        this->frames.append(page.frame);
+        this->referenced[page.frame] = true;
+    }
+
+    void accessed(const Page& page) override {
+        this->referenced[page.frame] = true;
+    }
+
+    int evict(const long&) override {
+        int frame = this->frames.front();
+
+        while (this->referenced[frame]) {
+            this->referenced[frame] = false;
+            this->frames.unlink(frame);
+            this->frames.append(frame);
+
+            frame = this->frames.front();
+        }
+
+        this->frames.unlink(frame);
+
+        return frame;
+    }
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+// Computes LRU's page faults for every number of frames at once. Since LRU is a stack algorithm, a reference hits with n frames exactly when fewer than n other pages were used since the last time it was, so counting those distinct pages (its stack distance) for each reference is enough
+class StackDistance {
+private:
+    int coldMisses = 0;
+    // How many references had each stack distance
+    std::vector<long> distances;
+    // Fenwick tree over reference times, marking the last time each page was used
+    std::vector<int> lastUses;
+    std::unordered_map<long, int> lastUse;
+    int time = 0;
+
+    void mark(int position, const int& delta) {
+        for (position += 1; position <= (int)this->lastUses.size(); position += position & -position) {
+            this->lastUses[position - 1] += delta;
+        }
+    }
+
+    // Number of marked times before the given one
+    int marked(int position) const {
+        int count = 0;
+
+        for (; position > 0; position -= position & -position) {
+            count += this->lastUses[position - 1];
+        }
+
+        return count;
+    }
+
+    // Doubles the tree, re-marking every page's last use
+    void grow() {
+        this->lastUses.assign(this->lastUses.empty() ? 1024 : this->lastUses.size() * 2, 0);
+
+        for (const auto& use : this->lastUse) {
+            this->mark(use.second, 1);
+        }
+    }
+
+public:
+    // Constructors
+    StackDistance() {}
+    explicit StackDistance(const int& referencesN) : lastUses(referencesN > 0 ? referencesN : 1, 0) {}
+
+    // Pages are told apart by their pageKey
+    void access(const long& key) {
+        if (this->time >= (int)this->lastUses.size()) {
+            this->grow();
+        }
+
+        auto found = this->lastUse.find(key);
+
+        if (found == this->lastUse.end()) {
+            this->coldMisses += 1;
+            this->lastUse[key] = this->time;
+        } else {
+            // Pages used since its last use, itself included
+            int distance = this->marked(this->time) - this->marked(found->second);
+
+            if (distance >= (int)this->distances.size()) {
+                this->distances.resize(distance + 1, 0);
+            }
+            this->distances[distance] += 1;
+
+            this->mark(found->second, -1);
+            found->second = this->time;
+        }
+
+        this->mark(this->time, 1);
+        this->time += 1;
+    }
+
+    // Number of distinct pages referenced, past which more frames don't help
+    int pagesN() const {
+        return this->lastUse.size();
+    }
+
+    long pageFaults(const int& framesN) const {
+        long faults = this->coldMisses;
+
+        for (int distance = framesN + 1; distance < (int)this->distances.size(); distance++) {
+            faults += this->distances[distance];
+        }
+
+        return faults;
+    }
+
+    // Page faults for 1 up to pagesN() frames, in a single pass over the distances
+    std::vector<long> pageFaultCurve() const {
+        std::vector<long> curve(this->pagesN(), this->coldMisses);
+
+        for (int framesN = this->pagesN() - 1; framesN >= 1; framesN--) {
+            curve[framesN - 1] = curve[framesN] + (framesN + 1 < (int)this->distances.size() ? this->distances[framesN + 1] : 0);
+        }
+
+        return curve;
+    }
+};
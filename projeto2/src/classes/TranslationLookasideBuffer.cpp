@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "./ReplacementPolicy.cpp"
+
+std::vector<std::string> supportedTlbPolicies = { "lru", "fifo", "random" };
+
+struct TlbConfig {
+    int entriesN;
+    int associativity;
+    std::string policy;
+};
+
+// Set-associative cache of page number to frame translations, tagged with their process (as an ASID) so they survive context switches. Entries are kept coherent with the page table by shooting them down when their page is evicted
+class TranslationLookasideBuffer {
+private:
+    struct Entry {
+        int pid;
+        PageNumber pageNumber;
+        int frame;
+        bool valid;
+        // Last use (LRU) or insertion (FIFO)
+        long stamp;
+    };
+
+    int associativity;
+    // Ways of set i are entries[i * associativity, (i + 1) * associativity)
+    std::vector<Entry> entries;
+    std::string policy;
+    int setsN;
+    long time = 0;
+    // Seeded so runs are reproducible
+    std::mt19937 generator;
+    long _hits = 0;
+    long _misses = 0;
+    long _shootdowns = 0;
+
+    Entry* find(const int& pid, const PageNumber& pageNumber) {
+        Entry* set = &this->entries[pageNumber % this->setsN * this->associativity];
+
+        for (int way = 0; way < this->associativity; way++) {
+            if (set[way].valid && set[way].pageNumber == pageNumber && set[way].pid == pid) {
+                return &set[way];
+            }
+        }
+
+        return nullptr;
+    }
+
+public:
+    // Constructors
+    explicit TranslationLookasideBuffer(const TlbConfig& config) : associativity(config.associativity), entries(std::max(config.entriesN, 0), { 0, 0, NO_FRAME, false, 0 }), policy(config.policy), generator(0) {
+        if (config.entriesN <= 0 || config.associativity <= 0 || config.entriesN % config.associativity != 0) {
+            throw std::invalid_argument("The TLB's entries must be a positive multiple of its associativity.");
+        }
+
+        if (std::find(supportedTlbPolicies.begin(), supportedTlbPolicies.end(), config.policy) == supportedTlbPolicies.end()) {
+            throw std::invalid_argument("Only LRU, FIFO and random TLB replacement are supported.");
+        }
+
+        this->setsN = config.entriesN / config.associativity;
+    }
+
+    // Frame of the given page if it's cached, NO_FRAME otherwise
+    int lookup(const int& pid, const PageNumber& pageNumber) {
+        this->time += 1;
+        Entry* entry = this->find(pid, pageNumber);
+
+        if (entry == nullptr) {
+            this->_misses += 1;
+
+            return NO_FRAME;
+        }
+
+        if (this->policy == "lru") {
+            entry->stamp = this->time;
+        }
+        this->_hits += 1;
+
+        return entry->frame;
+    }
+
+    // Caches a translation after a miss, replacing an empty way or, if there's none, one picked by the TLB's policy
+    void insert(const int& pid, const PageNumber& pageNumber, const int& frame) {
+        Entry* set = &this->entries[pageNumber % this->setsN * this->associativity];
+        Entry* victim = std::find_if(set, set + this->associativity, [](const Entry& entry) { return !entry.valid; });
+
+        if (victim == set + this->associativity) {
+            if (this->policy == "random") {
+                victim = set + std::uniform_int_distribution<int>(0, this->associativity - 1)(this->generator);
+            } else {
+                victim = std::min_element(set, set + this->associativity, [](const Entry& a, const Entry& b) { return a.stamp < b.stamp; });
+            }
+        }
+
+        *victim = { pid, pageNumber, frame, true, this->time };
+    }
+
+    // Drops the page's translation, as its frame's being reused
+    void shootdown(const int& pid, const PageNumber& pageNumber) {
+        Entry* entry = this->find(pid, pageNumber);
+
+        if (entry != nullptr) {
+            entry->valid = false;
+            this->_shootdowns += 1;
+        }
+    }
+
+    double hitRate() const {
+        long lookups = this->_hits + this->_misses;
+
+        return lookups > 0 ? (double)this->_hits / lookups : 0;
+    }
+
+    long hits() const {
+        return this->_hits;
+    }
+
+    long misses() const {
+        return this->_misses;
+    }
+
+    long shootdowns() const {
+        return this->_shootdowns;
+    }
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "./Page.cpp"
+
+struct TableConfig {
+    // "hash" (not modelled), "multilevel" or "inverted"
+    std::string layout;
+    // Multilevel tables only
+    int levelsN;
+    // Bits of the virtual page numbers
+    int pageNumberBits;
+};
+
+// Size of a table entry, as hardware would store it
+const long ENTRY_SIZE = 8;
+
+// Page tables laid out like real hardware's, one per process or shared by all of them, to measure how much memory they take and how many entries a walk reads
+class TranslationTable {
+protected:
+    long walks = 0;
+    long walkSteps = 0;
+
+public:
+    virtual ~TranslationTable() {}
+
+    // Walks the process' table, returning the page's frame or -1 if it isn't loaded
+    virtual int get(const int& pid, const PageNumber& pageNumber) = 0;
+    virtual void set(const int& pid, const PageNumber& pageNumber, const int& frame) = 0;
+    virtual void remove(const int& pid, const PageNumber& pageNumber) = 0;
+    // Mapped pages, across every process
+    virtual std::size_t size() const = 0;
+    // Most bytes the tables ever took
+    virtual long footprint() const = 0;
+
+    // Entries read per walk
+    double averageWalkDepth() const {
+        return this->walks > 0 ? (double)this->walkSteps / this->walks : 0;
+    }
+};
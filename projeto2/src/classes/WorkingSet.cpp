@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "./Page.cpp"
+
+// A process' working set (the distinct pages among its last `window` references) and page fault frequency (the share of those references that faulted), both measured in its own virtual time
+class WorkingSet {
+private:
+    int window;
+    // Circular buffer of the references in the window
+    std::vector<PageNumber> pages;
+    std::vector<bool> faults;
+    // References to each page in the window
+    std::unordered_map<PageNumber, int> counts;
+    long referencesN = 0;
+    int faultsN = 0;
+    long sizesSum = 0;
+    double peakFaultRate = 0;
+
+public:
+    // Constructors
+    explicit WorkingSet(const int& window) : window(window), pages(window), faults(window) {}
+
+    void access(const PageNumber& pageNumber, const bool& fault) {
+        int slot = this->referencesN % this->window;
+
+        // The oldest reference leaves the window
+        if (this->referencesN >= this->window) {
+            auto found = this->counts.find(this->pages[slot]);
+            if (--found->second == 0) {
+                this->counts.erase(found);
+            }
+
+            this->faultsN -= this->faults[slot];
+        }
+
+        this->pages[slot] = pageNumber;
+        this->faults[slot] = fault;
+        this->counts[pageNumber] += 1;
+        this->faultsN += fault;
+        this->referencesN += 1;
+
+        this->sizesSum += this->size();
+        // Only once the window's full, as the first faults are bound to be cold ones
+        if (this->referencesN >= this->window) {
+            this->peakFaultRate = std::max(this->peakFaultRate, this->faultRate());
+        }
+    }
+
+    double averageSize() const {
+        return this->referencesN > 0 ? (double)this->sizesSum / this->referencesN : 0;
+    }
+
+    double faultRate() const {
+        return this->referencesN > 0 ? (double)this->faultsN / std::min<long>(this->referencesN, this->window) : 0;
+    }
+
+    double maxFaultRate() const {
+        return this->peakFaultRate;
+    }
+
+    int size() const {
+        return this->counts.size();
+    }
+};
@@ -1,53 +1,464 @@
+#include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
 #include "./classes/MemoryManagementUnit.cpp"
+#include "./classes/ReferenceGenerator.cpp"
+#include "./classes/References.cpp"
+#include "./classes/StackDistance.cpp"
+#include "../../comum/parallelFor.cpp"
+#include "../../comum/parseRange.cpp"
+#include "../../comum/split.cpp"
+#include "./utils/simulate.cpp"
 
-struct SchedulerParams {
-    std::vector<std::string> algorithms;
-    std::vector<int> params;
+struct NamedAlgorithm {
+    std::string name;
+    std::string algorithm;
 };
 
-struct MMUs {
-    MemoryManagementUnit fifo;
-    MemoryManagementUnit otm;
-    MemoryManagementUnit lru;
-};
+// References are turned from virtual addresses to page numbers by dropping pageShift bits
+Trace readTrace(const std::string& path, const int& pageShift = 0) {
+    Trace trace = { 0, {}, {}, {}, {} };
+
+    TraceReader reader(path, MEMORY_TRACE);
+    // Page number and, optionally, whether it's a write and its process
+    std::uint64_t info[3];
+    int infoN;
+    while ((infoN = reader.readLine(info, 3)) > 0) {
+        if (trace.framesN == 0) {
+            trace.framesN = (int)info[0];
+        } else {
+            Reference reference = parseReference(info, infoN, pageShift);
+            trace.add(reference.pageNumber, reference.write, reference.pid);
+        }
+    }
+
+    trace.nextUses = findNextUses(trace.queue, trace.pids);
+
+    return trace;
+}
+
+// Writes a text trace's number of frames and references to a binary trace
+void convertTrace(const std::string& path, const std::string& output) {
+    TraceReader reader(path, MEMORY_TRACE);
+    std::uint64_t info[3];
+    int infoN;
+
+    if (reader.readLine(info, 1) == 0) {
+        throw std::invalid_argument("The trace needs a number of frames.");
+    }
+
+    BinaryTraceWriter writer(output, MEMORY_TRACE, info[0]);
+    while ((infoN = reader.readLine(info, 3)) > 0) {
+        writer.writeReference(info[0], infoN > 1 && info[1] != 0, infoN > 2 ? (int)info[2] : 0);
+    }
+}
+
+// Writes a synthetic trace straight to disk, as text or as a binary trace
+void generateTrace(const ReferenceConfig& config, const std::string& output, const bool& binary) {
+    ReferenceGenerator generator(config);
+    int pageNumber, pid;
+    bool write;
+
+    if (binary) {
+        BinaryTraceWriter writer(output, MEMORY_TRACE, generator.framesN());
+
+        while (generator.next(pageNumber, write, pid)) {
+            writer.writeReference(pageNumber, write, pid);
+        }
+
+        return;
+    }
+
+    std::ofstream file(output);
+    if (!file) {
+        throw std::invalid_argument("Couldn't open " + output + " for writing.");
+    }
+
+    file << generator.framesN() << "\n";
+    while (generator.next(pageNumber, write, pid)) {
+        file << pageNumber << " " << write << " " << pid << "\n";
+    }
+}
 
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
+    std::vector<std::string> paths;
+    int threadsN = std::thread::hardware_concurrency();
+    // Frame counts to evaluate instead of the one given by each trace
+    std::vector<int> framesNs;
+    // LRU's page faults for every frame count from a single pass
+    bool lruCurve = false;
+    // Read each file as it's simulated instead of loading it first, knowing only this many references ahead
+    bool streamed = false;
+    int lookahead = 1 << 20;
+    // Replacement policies to run, in output order
+    std::vector<std::string> algorithms = { "fifo", "otm", "lru" };
+    // Latencies of page faults and write-backs, reported along with them if any was given
+    CostModel costs = { 0, 0 };
+    bool costed = false;
+    // TLB, page table layout, replacement scope, working set window and page fault rate window of every MMU
+    MmuOptions options = { { 0, 1, "lru" }, { "hash", 0, 32 }, false, 0, 0 };
+    TlbConfig& tlbConfig = options.tlb;
+    TableConfig& tableConfig = options.table;
+    // Bits of the offset within a page, when references are virtual addresses
+    int pageShift = 0;
+    // Bits of the virtual addresses, such as 48 for today's 64-bit processors
+    int addressBits = 32;
+    // Binary trace to convert the input file to, instead of simulating it
+    std::string convertTo;
+    // Synthetic trace to generate, instead of simulating anything
+    std::string generateTo;
+    ReferenceConfig generated = { 100000, 64, "zipf:1:1024", 0, 1, 100, 1 };
+    bool binary = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--lru-curve") {
+            lruCurve = true;
+        } else if (arg == "--sweep-frames" && i + 1 < argc) {
+            framesNs = parseRange(argv[++i]);
+        } else if (arg == "--stream") {
+            streamed = true;
+        } else if (arg == "--lookahead" && i + 1 < argc) {
+            lookahead = std::stoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threadsN = std::stoi(argv[++i]);
+        } else if (arg == "--policies" && i + 1 < argc) {
+            algorithms = split(argv[++i], ",");
+        } else if (arg == "--fault-latency" && i + 1 < argc) {
+            costs.faultLatency = std::stol(argv[++i]);
+            costed = true;
+        } else if (arg == "--write-back-latency" && i + 1 < argc) {
+            costs.writeBackLatency = std::stol(argv[++i]);
+            costed = true;
+        } else if (arg == "--tlb" && i + 1 < argc) {
+            // ENTRIES[:ASSOCIATIVITY[:POLICY]], fully associative by default
+            std::istringstream config(argv[++i]);
+            std::string field;
+
+            std::getline(config, field, ':');
+            tlbConfig.entriesN = tlbConfig.associativity = std::stoi(field);
+            if (std::getline(config, field, ':')) {
+                tlbConfig.associativity = std::stoi(field);
+            }
+            if (std::getline(config, field, ':')) {
+                tlbConfig.policy = field;
+            }
+        } else if (arg == "--page-size" && i + 1 < argc) {
+            int pageSize = std::stoi(argv[++i]);
+
+            if (pageSize <= 0 || (pageSize & (pageSize - 1)) != 0) {
+                std::cout << "O tamanho da página deve ser uma potência de 2." << std::endl;
+
+                return 1;
+            }
+
+            pageShift = __builtin_ctz(pageSize);
+        } else if (arg == "--address-bits" && i + 1 < argc) {
+            addressBits = std::stoi(argv[++i]);
+        } else if (arg == "--page-table" && i + 1 < argc) {
+            // hash, inverted or multilevel:LEVELS
+            std::istringstream config(argv[++i]);
+            std::string field;
+
+            std::getline(config, tableConfig.layout, ':');
+            tableConfig.levelsN = std::getline(config, field, ':') ? std::stoi(field) : 2;
+        } else if (arg == "--replacement" && i + 1 < argc) {
+            std::string scope = argv[++i];
+
+            if (scope != "global" && scope != "local") {
+                std::cout << "A substituição deve ser global ou local." << std::endl;
+
+                return 1;
+            }
+
+            options.local = scope == "local";
+        } else if (arg == "--working-set-window" && i + 1 < argc) {
+            options.workingSetWindow = std::stoi(argv[++i]);
+        } else if (arg == "--fault-window" && i + 1 < argc) {
+            options.faultWindow = std::stoi(argv[++i]);
+        } else if (arg == "--convert" && i + 1 < argc) {
+            convertTo = argv[++i];
+        } else if (arg == "--generate" && i + 1 < argc) {
+            generateTo = argv[++i];
+        } else if (arg == "--count" && i + 1 < argc) {
+            generated.referencesN = std::stol(argv[++i]);
+        } else if (arg == "--frames" && i + 1 < argc) {
+            generated.framesN = std::stoi(argv[++i]);
+        } else if (arg == "--locality" && i + 1 < argc) {
+            generated.locality = argv[++i];
+        } else if (arg == "--write-ratio" && i + 1 < argc) {
+            generated.writeRatio = std::stod(argv[++i]);
+        } else if (arg == "--processes" && i + 1 < argc) {
+            generated.processesN = std::stoi(argv[++i]);
+        } else if (arg == "--slice" && i + 1 < argc) {
+            generated.sliceLength = std::stoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            generated.seed = std::stoull(argv[++i]);
+        } else if (arg == "--binary") {
+            binary = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cout << "Opção desconhecida: " << arg << std::endl;
+
+            return 1;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    // Page numbers are what's left of the addresses past the offset, which pageKey can only tell apart up to 48 bits
+    tableConfig.pageNumberBits = addressBits - pageShift;
+    if (addressBits > 64 || tableConfig.pageNumberBits < 1 || tableConfig.pageNumberBits > PAGE_KEY_BITS) {
+        std::cout << "Os números de página (endereços de até 64 bits sem o deslocamento) devem ter de 1 a 48 bits." << std::endl;
+
+        return 1;
+    }
+
+    if (!generateTo.empty()) {
+        generateTrace(generated, generateTo, binary);
+
+        return 0;
+    }
+
+    if (paths.empty()) {
         std::cout << "Por favor, informe o caminho do arquivo de entrada." << std::endl;
 
         return 1;
     }
 
-    int framesN = 0;
-    std::vector<int> queue;
+    if (!convertTo.empty()) {
+        convertTrace(paths.front(), convertTo);
+
+        return 0;
+    }
+
+    // Named after their algorithm, in upper case
+    std::vector<NamedAlgorithm> policies;
+    for (const std::string& algorithm : algorithms) {
+        if (std::find(supportedAlgorithms.begin(), supportedAlgorithms.end(), algorithm) == supportedAlgorithms.end()) {
+            std::cout << unsupportedAlgorithmMessage << std::endl;
 
-    std::ifstream input(argv[1]);
-    std::string line;
-    while (std::getline(input, line)) {
-        if (framesN == 0) {
-            framesN = stoi(line);
+            return 1;
+        }
+
+        std::string name = algorithm;
+        std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+        policies.push_back({ name, algorithm });
+    }
+    int filesN = paths.size(), policiesN = policies.size();
+
+    // Runs every job in parallel, printing why the first one that failed did (such as a reference outside the address space) instead of aborting
+    auto runJobs = [&](const int& jobsN, const std::function<void(int)>& job) {
+        try {
+            parallelFor(jobsN, job, threadsN);
+        } catch (const std::invalid_argument& error) {
+            std::cout << error.what() << std::endl;
+
+            return false;
+        }
+
+        return true;
+    };
+
+    std::vector<Trace> traces(streamed ? 0 : filesN);
+    if (!streamed) {
+        bool ran = runJobs(filesN, [&](int file) {
+            traces[file] = readTrace(paths[file], pageShift);
+        });
+        if (!ran) {
+            return 1;
+        }
+    }
+
+    auto makeMmu = [&](const int& framesN, const std::string& algorithm) {
+        return MemoryManagementUnit(framesN, algorithm, options);
+    };
+
+    // Page faults, then write-backs and stall time if there's a cost model, then TLB hit rate, misses and shootdowns if there's a TLB, then average walk depth and the table's footprint in bytes if it's modelled, then the average sum of working sets and the share of references they didn't fit in the RAM if they're tracked, then the median, 95th and 99th percentiles and maximum page fault rate over windows if they're measured
+    auto report = [&](const MemoryManagementUnit& mmu, const std::string& separator) {
+        std::ostringstream output;
+
+        output << mmu.pageFaults();
+        if (costed) {
+            output << separator << mmu.writeBacks() << separator << mmu.stallTime(costs);
+        }
+        if (mmu.tlb() != nullptr) {
+            output << std::fixed << std::setprecision(4) << separator << mmu.tlb()->hitRate() << separator << mmu.tlb()->misses() << separator << mmu.tlb()->shootdowns();
+        }
+        if (mmu.table() != nullptr) {
+            output << std::fixed << std::setprecision(4) << separator << mmu.table()->averageWalkDepth() << separator << mmu.table()->footprint();
+        }
+        if (options.workingSetWindow > 0) {
+            output << std::fixed << std::setprecision(4) << separator << mmu.averageWorkingSets() << separator << mmu.thrashingRate();
+        }
+        if (options.faultWindow > 0) {
+            output << std::fixed << std::setprecision(4);
+            for (double percent : { 50.0, 95.0, 99.0, 100.0 }) {
+                output << separator << mmu.pageFaultRate(percent);
+            }
+        }
+
+        return output.str();
+    };
+
+    // Calls job with the file's references, from wherever they are
+    auto withReferences = [&](const int& file, auto job) {
+        if (streamed) {
+            StreamedReferences references(paths[file], lookahead, pageShift);
+            job(references);
         } else {
-            queue.push_back(stoi(line));
+            TraceReferences references(traces[file]);
+            job(references);
         }
+    };
+
+    if (lruCurve) {
+        std::vector<std::string> outputs(filesN);
+        bool ran = runJobs(filesN, [&](int file) {
+            StackDistance distances;
+
+            withReferences(file, [&](auto& references) {
+                Reference reference;
+
+                while (references.next(reference)) {
+                    checkPageNumber(reference.pageNumber, tableConfig.pageNumberBits);
+                    distances.access(pageKey(reference.pid, reference.pageNumber));
+                }
+            });
+
+            // Either the requested frame counts or every one that makes a difference
+            std::ostringstream output;
+            if (framesNs.empty()) {
+                std::vector<long> curve = distances.pageFaultCurve();
+
+                for (int framesN = 1; framesN <= (int)curve.size(); framesN++) {
+                    output << paths[file] << "," << framesN << "," << curve[framesN - 1] << std::endl;
+                }
+            } else {
+                for (int framesN : framesNs) {
+                    output << paths[file] << "," << framesN << "," << distances.pageFaults(framesN) << std::endl;
+                }
+            }
+            outputs[file] = output.str();
+        });
+        if (!ran) {
+            return 1;
+        }
+
+        std::cout << "arquivo,quadros,lru" << std::endl;
+        for (const std::string& output : outputs) {
+            std::cout << output;
+        }
+
+        return 0;
+    }
+
+    if (!framesNs.empty()) {
+        int framesNsN = framesNs.size(), pointsN = filesN * framesNsN;
+
+        // Every policy for every frame count of every file runs on its own, reusing the parsed trace (if it isn't streamed)
+        std::vector<std::string> cells(pointsN * policiesN);
+        bool ran = runJobs(pointsN * policiesN, [&](int job) {
+            int point = job / policiesN;
+            MemoryManagementUnit mmu = makeMmu(framesNs[point % framesNsN], policies[job % policiesN].algorithm);
+
+            withReferences(point / framesNsN, [&](auto& references) {
+                simulate(mmu, references);
+            });
+
+            cells[job] = report(mmu, ",");
+        });
+        if (!ran) {
+            return 1;
+        }
+
+        std::cout << "arquivo,quadros";
+        for (const NamedAlgorithm& policy : policies) {
+            std::cout << "," << policy.algorithm;
+            if (costed) {
+                std::cout << "," << policy.algorithm << "_escritas," << policy.algorithm << "_espera";
+            }
+            if (tlbConfig.entriesN > 0) {
+                std::cout << "," << policy.algorithm << "_tlb_taxa_acertos," << policy.algorithm << "_tlb_faltas," << policy.algorithm << "_tlb_invalidacoes";
+            }
+            if (tableConfig.layout != "hash") {
+                std::cout << "," << policy.algorithm << "_profundidade," << policy.algorithm << "_tabela_bytes";
+            }
+            if (options.workingSetWindow > 0) {
+                std::cout << "," << policy.algorithm << "_conjuntos_trabalho," << policy.algorithm << "_thrashing";
+            }
+            if (options.faultWindow > 0) {
+                std::cout << "," << policy.algorithm << "_taxa_faltas_p50," << policy.algorithm << "_taxa_faltas_p95," << policy.algorithm << "_taxa_faltas_p99," << policy.algorithm << "_taxa_faltas_max";
+            }
+        }
+        std::cout << std::endl;
+
+        for (int point = 0; point < pointsN; point++) {
+            std::cout << paths[point / framesNsN] << "," << framesNs[point % framesNsN];
+            for (int policy = 0; policy < policiesN; policy++) {
+                std::cout << "," << cells[point * policiesN + policy];
+            }
+            std::cout << std::endl;
+        }
+
+        return 0;
     }
 
-    MMUs mmus = { MemoryManagementUnit(framesN, "fifo", queue), MemoryManagementUnit(framesN, "otm", queue), MemoryManagementUnit(framesN, "lru", queue) };
+    // Every policy of every file runs on its own, sharing the (read-only) trace and writing to its own output
+    std::vector<std::string> outputs(filesN * policiesN);
+    bool ran = runJobs(filesN * policiesN, [&](int job) {
+        const NamedAlgorithm& policy = policies[job % policiesN];
+        std::ostringstream output;
+
+        withReferences(job / policiesN, [&](auto& references) {
+            MemoryManagementUnit mmu = makeMmu(references.framesN(), policy.algorithm);
+            simulate(mmu, references);
+
+            output << policy.name << " " << report(mmu, " ") << std::endl;
+
+            // Followed by each process' page faults and, if tracked, average working set and peak page fault frequency
+            if (mmu.processesN() > 1 || options.workingSetWindow > 0) {
+                for (int pid = 0; pid < mmu.processesEnd(); pid++) {
+                    if (!mmu.processSeen(pid)) {
+                        continue;
+                    }
 
-    for (int page : queue) {
-        mmus.fifo.getPage(page);
-        mmus.otm.getPage(page);
-        mmus.lru.getPage(page);
+                    output << "  " << pid << " " << mmu.processPageFaults(pid);
+                    if (mmu.workingSet(pid) != nullptr) {
+                        output << std::fixed << std::setprecision(4) << " " << mmu.workingSet(pid)->averageSize() << " " << mmu.workingSet(pid)->maxFaultRate();
+                    }
+                    output << std::endl;
+                }
+            }
+        });
+
+        outputs[job] = output.str();
+    });
+    if (!ran) {
+        return 1;
     }
 
-    std::cout << "FIFO " << mmus.fifo.pageFaults() << std::endl;
-    std::cout << "OTM " << mmus.otm.pageFaults() << std::endl;
-    std::cout << "LRU " << mmus.lru.pageFaults() << std::endl;
+    // Which are then printed in order, no matter which one finished first
+    for (int file = 0; file < filesN; file++) {
+        if (filesN > 1) {
+            std::cout << paths[file] << std::endl;
+        }
+
+        for (int policy = 0; policy < policiesN; policy++) {
+            std::cout << outputs[file * policiesN + policy];
+        }
+    }
 
     return 0;
 }
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "../classes/MemoryManagementUnit.cpp"
+#include "../classes/References.cpp"
+
+// Runs every reference (from either TraceReferences or StreamedReferences) through the MMU
+template <typename References>
+void simulate(MemoryManagementUnit& mmu, References& references) {
+    Reference reference;
+
+    while (references.next(reference)) {
+        mmu.getPage(reference.pageNumber, reference.nextUse, reference.write, reference.pid);
+    }
+}